@@ -0,0 +1,35 @@
+/**
+ * @brief Minimal timing for benchmarks.
+ *
+ * Every benchmark is executable, that prints time spent in each measured case.
+ * Numbers are only comparable between cases of one run on one machine.
+ */
+
+#ifndef BENCH_H_included
+#define BENCH_H_included
+
+#include <stdio.h>
+#include <time.h>
+
+//results are summed here, so measured work can't be optimized out
+static volatile unsigned long bench_sink = 0;
+
+static clock_t bench_started = 0;
+
+#define BENCH_START() (bench_started = clock())
+
+#define BENCH_MS() (1000.0 * (double)(clock() - bench_started) / CLOCKS_PER_SEC)
+
+#define BENCH_REPORT(name, ops) \
+    do{ \
+        double bench_ms = BENCH_MS(); \
+        printf("%-44s %10.2f ms %10.2f ns/op\n", (name), bench_ms, bench_ms * 1e6 / (double)(ops)); \
+    }while(0)
+
+#define BENCH_REPORT_BYTES(name, bytes) \
+    do{ \
+        double bench_ms = BENCH_MS(); \
+        printf("%-44s %10.2f ms %10.2f MB/s\n", (name), bench_ms, (double)(bytes) / 1e3 / bench_ms); \
+    }while(0)
+
+#endif
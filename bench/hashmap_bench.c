@@ -0,0 +1,127 @@
+#include <string.h>
+
+#include <utillib/core.h>
+
+#include "bench.h"
+
+#define LOOKUPS 2000000
+#define SCAN_LOOKUPS 20000
+
+static char **make_keys(unsigned count){
+    char **keys = (char **)dynmem_malloc(count * sizeof(char *));
+
+    for(unsigned i = 0; i < count; i++){
+        keys[i] = (char *)dynmem_malloc(32);
+        sprintf(keys[i], "--option-%u", i);
+    }
+
+    return keys;
+}
+
+static void free_keys(char **keys, unsigned count){
+    for(unsigned i = 0; i < count; i++){
+        dynmem_free(keys[i]);
+    }
+
+    dynmem_free(keys);
+}
+
+//lookup by walking list of keys, like options_t did before hashmap
+static void bench_list_scan(char **keys, unsigned count){
+    list_t *list = NULL;
+    unsigned long found = 0;
+    char name[64];
+
+    list_init(&list, sizeof(char *));
+
+    for(unsigned i = 0; i < count; i++){
+        list_append(list, &(keys[i]));
+    }
+
+    BENCH_START();
+    for(unsigned i = 0; i < SCAN_LOOKUPS; i++){
+        const char *key = keys[(i * 7919u) % count];
+
+        for(unsigned j = 0; j < list_count(list); j++){
+            char *item = NULL;
+            list_at(list, j, &item);
+
+            if(strcmp(item, key) == 0){
+                found++;
+                break;
+            }
+        }
+    }
+
+    sprintf(name, "list scan: lookup in %u keys", count);
+    BENCH_REPORT(name, SCAN_LOOKUPS);
+
+    bench_sink += found;
+    list_destroy(list);
+}
+
+static void bench_hashmap(char **keys, unsigned count){
+    hashmap_t *map = NULL;
+    unsigned long found = 0;
+    char name[64];
+
+    hashmap_init(&map, sizeof(char *), sizeof(unsigned), hashmap_hash_cstr, hashmap_equal_cstr);
+
+    for(unsigned i = 0; i < count; i++){
+        hashmap_set(map, &(keys[i]), &i);
+    }
+
+    BENCH_START();
+    for(unsigned i = 0; i < LOOKUPS; i++){
+        char *key = keys[(i * 7919u) % count];
+        found += hashmap_contains(map, &key);
+    }
+
+    sprintf(name, "hashmap: lookup in %u keys", count);
+    BENCH_REPORT(name, LOOKUPS);
+
+    bench_sink += found;
+    hashmap_destroy(map);
+}
+
+//insertions with growing table and removal of every key
+static void bench_hashmap_set_remove(char **keys, unsigned count){
+    hashmap_t *map = NULL;
+    unsigned rounds = LOOKUPS / count;
+
+    hashmap_init(&map, sizeof(char *), sizeof(unsigned), hashmap_hash_cstr, hashmap_equal_cstr);
+
+    BENCH_START();
+    for(unsigned round = 0; round < rounds; round++){
+        for(unsigned i = 0; i < count; i++){
+            hashmap_set(map, &(keys[i]), &i);
+        }
+
+        for(unsigned i = 0; i < count; i++){
+            hashmap_remove(map, &(keys[i]));
+        }
+    }
+
+    BENCH_REPORT("hashmap: set and remove", 2 * rounds * count);
+
+    hashmap_destroy(map);
+}
+
+int main(void){
+    unsigned counts[] = {8, 64, 1000};
+
+    for(unsigned i = 0; i < 3; i++){
+        char **keys = make_keys(counts[i]);
+
+        bench_list_scan(keys, counts[i]);
+        bench_hashmap(keys, counts[i]);
+
+        free_keys(keys, counts[i]);
+    }
+
+    char **keys = make_keys(100000);
+    bench_hashmap_set_remove(keys, 100000);
+    free_keys(keys, 100000);
+
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <utillib/core.h>
+
+#include "bench.h"
+
+#define BIG_COUNT 1000000
+#define INDEXED_COUNT 20000
+#define STACK_DEPTH 100000
+#define STACK_ROUNDS 20
+
+static const char *backend_name(list_backend_t backend){
+    return (backend == LIST_BACKEND_CHUNKED) ? "chunked" : "linked";
+}
+
+static void fill(list_t *list, unsigned count){
+    for(unsigned i = 0; i < count; i++){
+        list_append(list, &i);
+    }
+}
+
+static void bench_append(list_backend_t backend){
+    list_t *list = NULL;
+    char name[64];
+
+    BENCH_START();
+    list_init_allocator(&list, sizeof(unsigned), backend, dynmem_allocator_default());
+    fill(list, BIG_COUNT);
+    list_destroy(list);
+
+    sprintf(name, "%s: append and destroy", backend_name(backend));
+    BENCH_REPORT(name, BIG_COUNT);
+}
+
+//loop with increasing position, pattern used through whole library
+static void bench_indexed(list_backend_t backend, unsigned count){
+    list_t *list = NULL;
+    unsigned long sum = 0;
+    char name[64];
+
+    list_init_allocator(&list, sizeof(unsigned), backend, dynmem_allocator_default());
+    fill(list, count);
+
+    BENCH_START();
+    for(unsigned i = 0; i < count; i++){
+        unsigned value = 0;
+        list_at(list, i, &value);
+        sum += value;
+    }
+
+    sprintf(name, "%s: list_at loop over %u items", backend_name(backend), count);
+    BENCH_REPORT(name, count);
+
+    bench_sink += sum;
+    list_destroy(list);
+}
+
+static void bench_iterate(list_backend_t backend){
+    list_t *list = NULL;
+    list_iter_t it;
+    unsigned long sum = 0;
+    char name[64];
+
+    list_init_allocator(&list, sizeof(unsigned), backend, dynmem_allocator_default());
+    fill(list, BIG_COUNT);
+
+    BENCH_START();
+    for(list_iter_begin(list, &it); list_iter_valid(&it); list_iter_next(&it)){
+        sum += *(unsigned *)list_iter_data(&it);
+    }
+
+    sprintf(name, "%s: iterate", backend_name(backend));
+    BENCH_REPORT(name, BIG_COUNT);
+
+    bench_sink += sum;
+    list_destroy(list);
+}
+
+//token queue, filled by tokenizer and emptied by parser
+static void bench_queue(list_backend_t backend){
+    queue_t *queue = NULL;
+    unsigned long sum = 0;
+    char name[64];
+
+    queue_init_allocator(&queue, sizeof(unsigned), backend, dynmem_allocator_default());
+
+    BENCH_START();
+    for(unsigned round = 0; round < 10; round++){
+        for(unsigned i = 0; i < BIG_COUNT / 10; i++){
+            queue_append(queue, &i);
+        }
+
+        while(queue_count(queue) > 0){
+            unsigned value = 0;
+            queue_windraw(queue, &value);
+            sum += value;
+        }
+    }
+
+    sprintf(name, "%s: queue append and windraw", backend_name(backend));
+    BENCH_REPORT(name, BIG_COUNT);
+
+    bench_sink += sum;
+    queue_destroy(queue);
+}
+
+static void bench_insert_middle(list_backend_t backend){
+    list_t *list = NULL;
+    char name[64];
+
+    list_init_allocator(&list, sizeof(unsigned), backend, dynmem_allocator_default());
+
+    BENCH_START();
+    for(unsigned i = 0; i < INDEXED_COUNT; i++){
+        list_insert(list, list_count(list) / 2, &i);
+    }
+
+    sprintf(name, "%s: insert in middle", backend_name(backend));
+    BENCH_REPORT(name, INDEXED_COUNT);
+
+    list_destroy(list);
+}
+
+typedef struct{
+    void *payload;
+    ilist_link_t link;
+}node_t;
+
+//stack of pointers filled and emptied repeatedly, like evaluator solver stack
+static void bench_push_pop(const char *name, list_backend_t backend, unsigned slab_items){
+    stack_t *stack = NULL;
+    unsigned long sum = 0;
+
+    stack_init_allocator(&stack, sizeof(void *), backend, dynmem_allocator_default());
+
+    if(slab_items > 0)
+        stack_config_pool(stack, slab_items);
+
+    BENCH_START();
+    for(unsigned round = 0; round < STACK_ROUNDS; round++){
+        for(unsigned i = 0; i < STACK_DEPTH; i++){
+            void *pointer = (void *)&sum;
+            stack_push(stack, &pointer);
+        }
+
+        for(unsigned i = 0; i < STACK_DEPTH; i++){
+            void *pointer = NULL;
+            stack_pop(stack, &pointer);
+            sum += (pointer != NULL);
+        }
+    }
+
+    BENCH_REPORT(name, STACK_ROUNDS * STACK_DEPTH);
+
+    bench_sink += sum;
+    stack_destroy(stack);
+}
+
+//same workload with nodes owned by caller
+static void bench_push_pop_intrusive(void){
+    node_t *nodes = (node_t *)dynmem_malloc(STACK_DEPTH * sizeof(node_t));
+    ilist_t stack;
+    unsigned long sum = 0;
+
+    ilist_init(&stack);
+
+    BENCH_START();
+    for(unsigned round = 0; round < STACK_ROUNDS; round++){
+        for(unsigned i = 0; i < STACK_DEPTH; i++){
+            nodes[i].payload = (void *)&sum;
+            ilist_append(&stack, &(nodes[i].link));
+        }
+
+        for(unsigned i = 0; i < STACK_DEPTH; i++){
+            node_t *node = ILIST_ENTRY(ilist_pop(&stack), node_t, link);
+            sum += (node->payload != NULL);
+        }
+    }
+
+    BENCH_REPORT("ilist: push and pop", STACK_ROUNDS * STACK_DEPTH);
+
+    bench_sink += sum;
+    dynmem_free(nodes);
+}
+
+int main(void){
+    list_backend_t backends[] = {LIST_BACKEND_LINKED, LIST_BACKEND_CHUNKED};
+
+    for(unsigned i = 0; i < 2; i++){
+        bench_append(backends[i]);
+        bench_indexed(backends[i], INDEXED_COUNT);
+        bench_iterate(backends[i]);
+        bench_queue(backends[i]);
+        bench_insert_middle(backends[i]);
+    }
+
+    bench_push_pop("linked: push and pop", LIST_BACKEND_LINKED, 0);
+    bench_push_pop("linked with pool: push and pop", LIST_BACKEND_LINKED, 256);
+    bench_push_pop("chunked: push and pop", LIST_BACKEND_CHUNKED, 0);
+    bench_push_pop_intrusive();
+
+    //linked list would take hours here
+    bench_indexed(LIST_BACKEND_CHUNKED, BIG_COUNT);
+
+    return 0;
+}
@@ -0,0 +1,146 @@
+#include <stdio.h>
+
+#include <utillib/core.h>
+#include <utillib/utils.h>
+
+#include "bench.h"
+
+#define FILE_LINES 500000
+#define READ_CHUNK_SIZE 65536
+
+static const char *temp_file = "mapped_file_bench.tmp";
+
+static size_t make_file(void){
+    FILE *fp = fopen(temp_file, "wb");
+    size_t length = 0;
+
+    if(fp == NULL)
+        return 0;
+
+    for(unsigned i = 0; i < FILE_LINES; i++){
+        int written = fprintf(fp, "label_%u: mov r%u, 0x%04X //comment %u\n", i, i % 16, i & 0xFFFF, i);
+        length += (size_t)written;
+    }
+
+    fclose(fp);
+
+    return length;
+}
+
+static void finish(tokenizer_t *tokenizer){
+    queue_t *output = NULL;
+
+    tokenizer_end(tokenizer, &output);
+    bench_sink += queue_count(output);
+    tokenizer_clean_output_queue(output);
+}
+
+//whole file read by stdio in chunks, each chunk is tokenized separately
+static void bench_fread_chunks(size_t length){
+    tokenizer_t *tokenizer = NULL;
+    char *chunk = (char *)dynmem_malloc(READ_CHUNK_SIZE);
+
+    BENCH_START();
+    FILE *fp = fopen(temp_file, "rb");
+
+    tokenizer_init(&tokenizer);
+
+    while(true){
+        size_t read = fread(chunk, sizeof(char), READ_CHUNK_SIZE, fp);
+
+        if(read == 0)
+            break;
+
+        tokenizer_tokenize_view(tokenizer, string_view_make(chunk, read));
+    }
+
+    fclose(fp);
+    finish(tokenizer);
+
+    BENCH_REPORT_BYTES("fread chunks: tokenize", length);
+
+    dynmem_free(chunk);
+}
+
+static void bench_tokenize_file(size_t length){
+    tokenizer_t *tokenizer = NULL;
+
+    BENCH_START();
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_file(tokenizer, (char *)temp_file);
+    finish(tokenizer);
+
+    BENCH_REPORT_BYTES("tokenizer_tokenize_file", length);
+}
+
+static void bench_mapped(const char *name, size_t length, bool retain){
+    tokenizer_t *tokenizer = NULL;
+    mapped_file_t *file = NULL;
+
+    BENCH_START();
+    mapped_file_open(&file, (char *)temp_file);
+
+    tokenizer_init(&tokenizer);
+
+    if(retain)
+        tokenizer_config_retain_input(tokenizer);
+
+    tokenizer_tokenize_mapped_file(tokenizer, file);
+    finish(tokenizer);
+
+    mapped_file_close(file);
+
+    BENCH_REPORT_BYTES(name, length);
+}
+
+//tokens are pulled one by one and destroyed right away
+static void bench_mapped_next(size_t length){
+    tokenizer_t *tokenizer = NULL;
+    mapped_file_t *file = NULL;
+    token_t *token = NULL;
+    unsigned long count = 0;
+
+    BENCH_START();
+    mapped_file_open(&file, (char *)temp_file);
+
+    tokenizer_init(&tokenizer);
+    tokenizer_config_retain_input(tokenizer);
+    tokenizer_begin_mapped_file(tokenizer, file);
+
+    while(tokenizer_next(tokenizer, &token)){
+        count++;
+        tokenizer_token_destroy(token);
+    }
+
+    finish(tokenizer);
+    mapped_file_close(file);
+
+    BENCH_REPORT_BYTES("mapped: tokenizer_next", length);
+
+    bench_sink += count;
+}
+
+int main(void){
+    size_t length = make_file();
+
+    if(length == 0){
+        fprintf(stderr, "Can't create %s\n", temp_file);
+        return 1;
+    }
+
+    //untimed pass, file is then in page cache and heap is grown for every case
+    tokenizer_t *tokenizer = NULL;
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_file(tokenizer, (char *)temp_file);
+    finish(tokenizer);
+
+    bench_fread_chunks(length);
+    bench_tokenize_file(length);
+    bench_mapped("mapped: tokenize, copied tokens", length, false);
+    bench_mapped("mapped: tokenize, retained input", length, true);
+    bench_mapped_next(length);
+
+    remove(temp_file);
+
+    return 0;
+}
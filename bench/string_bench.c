@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <inttypes.h>
+
+#include <utillib/core.h>
+#include <utillib/files.h>
+
+#include "bench.h"
+
+#define APPEND_COUNT 400000
+#define IHEX_SIZE (256 * 1024)
+#define MIF_DEPTH (64 * 1024)
+#define SHORT_COUNT 2000000
+
+static const char *temp_file = "string_bench.tmp";
+
+//byte by byte formatting, like ihex data records
+static void bench_appendf(void){
+    string_t *s = NULL;
+
+    string_init(&s);
+
+    BENCH_START();
+    for(unsigned i = 0; i < APPEND_COUNT; i++){
+        string_appendf(s, "%02"PRIX8, (uint8_t)i);
+    }
+
+    BENCH_REPORT("string_appendf: byte in hex", APPEND_COUNT);
+
+    bench_sink += string_length(s);
+    string_destroy(s);
+}
+
+//argument points into the string itself
+static void bench_appendf_self(void){
+    string_t *s = NULL;
+
+    string_init(&s);
+
+    BENCH_START();
+    for(unsigned i = 0; i < APPEND_COUNT / 10; i++){
+        string_printf(s, "ab");
+        string_appendf(s, "%s%s", string_get(s), string_get(s));
+    }
+
+    BENCH_REPORT("string_appendf: own content", APPEND_COUNT / 10);
+
+    bench_sink += string_length(s);
+    string_destroy(s);
+}
+
+//short strings, like tokens or option names, live in inline storage
+static void bench_create_destroy(const char *name, const char *text){
+    unsigned long sum = 0;
+
+    BENCH_START();
+    for(unsigned i = 0; i < SHORT_COUNT; i++){
+        string_t *s = NULL;
+
+        string_init(&s);
+        string_append(s, (char *)text);
+        sum += string_length(s);
+        string_destroy(s);
+    }
+
+    BENCH_REPORT(name, SHORT_COUNT);
+
+    bench_sink += sum;
+}
+
+static void bench_ihex_write(void){
+    ihex_file_t *file = NULL;
+
+    ihex_init(&file, IHEX_SIZE, 0);
+
+    for(uint32_t i = 0; i < IHEX_SIZE; i++){
+        ihex_data(file)[i] = (uint8_t)(i * 31);
+    }
+
+    BENCH_START();
+    ihex_write(file, (char *)temp_file);
+    BENCH_REPORT("ihex_write: bytes", IHEX_SIZE);
+
+    remove(temp_file);
+    ihex_destroy(file);
+}
+
+static void bench_mif_write(void){
+    mif_file_t *file = NULL;
+
+    mif_init(&file, MIF_DEPTH, sizeof(uint32_t));
+    mif_config_radixes(file, RADIX_HEX, RADIX_HEX);
+
+    for(unsigned i = 0; i < MIF_DEPTH; i++){
+        mif_data(file)[i] = (uintmax_t)i * 2654435761u % 0xFFFFFFFFu;
+    }
+
+    BENCH_START();
+    mif_write(file, (char *)temp_file);
+    BENCH_REPORT("mif_write: words", MIF_DEPTH);
+
+    remove(temp_file);
+    mif_destroy(file);
+}
+
+int main(void){
+    bench_appendf();
+    bench_appendf_self();
+    bench_create_destroy("string: create and destroy short", "tokenizer");
+    bench_create_destroy("string: create and destroy long", "string longer than inline storage of string_t");
+    bench_ihex_write();
+    bench_mif_write();
+
+    return 0;
+}
@@ -13,7 +13,10 @@
 #include "../../src/core/src/check.h"
 #include "../../src/core/src/dynmem.h"
 #include "../../src/core/src/error.h"
+#include "../../src/core/src/hashmap.h"
+#include "../../src/core/src/ilist.h"
 #include "../../src/core/src/list.h"
 #include "../../src/core/src/string.h"
+#include "../../src/core/src/string_view.h"
 
 #endif
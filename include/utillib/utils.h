@@ -10,6 +10,7 @@
 #include "../../src/utils/src/convert.h"
 #include "../../src/utils/src/error_buffer.h"
 #include "../../src/utils/src/evaluate.h"
+#include "../../src/utils/src/mapped_file.h"
 #include "../../src/utils/src/tokenizer.h"
 #include "../../src/utils/src/string_cache.h"
 
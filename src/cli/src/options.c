@@ -36,6 +36,7 @@ typedef struct {
 } set_option_t;
 
 static void options_append(options_t *this, option_type_t type, options_arg_type_t arg_type, char *short_form, char *long_form, char *help);
+static void options_set_given(options_t *this, set_option_t *option);
 static void print_auto_newline(FILE *FP, char *s, unsigned max_len, unsigned first_line_len, unsigned indentation, unsigned indentation_first_line);
 
 void options_init(options_t **this, char *version, char *prog_name){
@@ -48,11 +49,17 @@ void options_init(options_t **this, char *version, char *prog_name){
 
     tmp->options_configured = NULL;
     tmp->options_given = NULL;
+    tmp->long_forms = NULL;
+    tmp->short_forms = NULL;
+    tmp->given_values = NULL;
     tmp->arguments_given = NULL;
     tmp->error_buffer = NULL;
 
     list_init(&(tmp->options_configured), sizeof(flag_t));
     list_init(&(tmp->options_given), sizeof(set_option_t));
+    hashmap_init(&(tmp->long_forms), sizeof(char *), sizeof(flag_t), hashmap_hash_cstr, hashmap_equal_cstr);
+    hashmap_init(&(tmp->short_forms), sizeof(char *), sizeof(flag_t), hashmap_hash_cstr, hashmap_equal_cstr);
+    hashmap_init(&(tmp->given_values), sizeof(char *), sizeof(char *), hashmap_hash_cstr, hashmap_equal_cstr);
     array_init(&(tmp->arguments_given), sizeof(char *), 16);
 
     error_buffer_init(&(tmp->error_buffer));
@@ -71,6 +78,9 @@ void options_destroy(options_t *this){
 
     list_destroy(this->options_configured);
     list_destroy(this->options_given);
+    hashmap_destroy(this->long_forms);
+    hashmap_destroy(this->short_forms);
+    hashmap_destroy(this->given_values);
     array_destroy(this->arguments_given);
     error_buffer_destroy(this->error_buffer);
 
@@ -108,33 +118,26 @@ int options_parse(options_t *this, int argc, char **argv){
         set_option_t tmp_set;
 
         if(flags_finished == false){
-            for(unsigned bagr = 0; bagr < list_count(this->options_configured); bagr++){
-                flag_t tmp_flag;
-                list_at(this->options_configured, bagr, (void *)&tmp_flag);
+            flag_t *found = NULL;
 
-                if(tmp_flag.option_type == SECTION)
-                    continue;
+            if(strncmp(arg, "--" , 2) == 0){
+                char *name = arg + 2;
+                found = (flag_t *)hashmap_at(this->long_forms, (void *)&name);
 
-                if(strncmp(arg, "--" , 2) == 0 && tmp_flag.long_form != NULL){
-                    if(strcmp(arg + 2, tmp_flag.long_form) == 0){
-                        if(tmp_flag.option_type == OPTION)
-                            is_option = true;
-                        else
-                            is_flag = true;
-                        is_long_form = true;
-                        break;
-                    }
-                }
+                if(found != NULL)
+                    is_long_form = true;
+            }
 
-                if(strncmp(arg, "-" , 1) == 0 && tmp_flag.short_form != NULL){
-                    if(strcmp(arg + 1, tmp_flag.short_form) == 0){
-                        if(tmp_flag.option_type == OPTION)
-                            is_option = true;
-                        else
-                            is_flag = true;
-                        break;
-                    }
-                }
+            if(found == NULL && strncmp(arg, "-" , 1) == 0){
+                char *name = arg + 1;
+                found = (flag_t *)hashmap_at(this->short_forms, (void *)&name);
+            }
+
+            if(found != NULL){
+                if(found->option_type == OPTION)
+                    is_option = true;
+                else
+                    is_flag = true;
             }
 
             if(is_option == true){
@@ -142,7 +145,7 @@ int options_parse(options_t *this, int argc, char **argv){
                     char *val = argv[++i];
                     tmp_set.flag = arg + (is_long_form ? 2 : 1);
                     tmp_set.value = val;
-                    list_append(this->options_given, (void *)&tmp_set);
+                    options_set_given(this, &tmp_set);
                     continue;
                 }
                 else{
@@ -153,7 +156,7 @@ int options_parse(options_t *this, int argc, char **argv){
             if(is_flag == true){
                 tmp_set.flag = arg + (is_long_form ? 2 : 1);
                 tmp_set.value = NULL;
-                list_append(this->options_given, (void *)&tmp_set);
+                options_set_given(this, &tmp_set);
                 continue;
             }
 
@@ -182,14 +185,7 @@ bool options_is_flag_set(options_t *this, char *s){
     CHECK_NULL_ARGUMENT(this);
     CHECK_NULL_ARGUMENT(s);
 
-    for(unsigned i = 0; i < list_count(this->options_given); i++){
-        set_option_t tmp_set;
-        list_at(this->options_given, i, (void *)&tmp_set);
-
-        if(tmp_set.flag != NULL && strcmp(tmp_set.flag, s) == 0)
-            return true;
-    }
-    return false;
+    return hashmap_contains(this->given_values, (void *)&s);
 }
 
 bool options_is_option_set(options_t *this, char *s){
@@ -207,9 +203,11 @@ void options_get_option_multiple_values_string(options_t *this, char *s, list_t
 
     list_init(val, sizeof(char *));
 
-    for(unsigned i = 0; i < list_count(this->options_given); i++){
+    list_iter_t it;
+
+    for(list_iter_begin(this->options_given, &it); list_iter_valid(&it); list_iter_next(&it)){
         set_option_t tmp_set;
-        list_at(this->options_given, i, (void *)&tmp_set);
+        list_iter_get(&it, (void *)&tmp_set);
 
         if(tmp_set.flag != NULL && strcmp(tmp_set.flag, s) == 0){
             list_append(*val, (void *)&tmp_set.value);
@@ -223,15 +221,8 @@ bool options_get_option_value_string(options_t *this, char *s, char **val){
     CHECK_NULL_ARGUMENT(val);
     CHECK_NOT_NULL_ARGUMENT(*val);
 
-    for(unsigned i = 0; i < list_count(this->options_given); i++){
-        set_option_t tmp_set;
-        list_at(this->options_given, i, (void *)&tmp_set);
-
-        if(tmp_set.flag != NULL && strcmp(tmp_set.flag, s) == 0){
-            *val = tmp_set.value;
-            return true;
-        }
-    }
+    if(hashmap_get(this->given_values, (void *)&s, (void *)val))
+        return true;
 
     error_buffer_write(this->error_buffer, "Argument %s is not given.", s);
 
@@ -275,9 +266,11 @@ void options_print_help(options_t *this){
     unsigned short_form_len = 0;
     unsigned long_form_len = 0;
 
-    for(unsigned i = 0; i < list_count(this->options_configured); i++){
+    list_iter_t it;
+
+    for(list_iter_begin(this->options_configured, &it); list_iter_valid(&it); list_iter_next(&it)){
         flag_t tmp;
-        list_at(this->options_configured, i, (void *)&tmp);
+        list_iter_get(&it, (void *)&tmp);
 
         if(tmp.option_type == SECTION)
             continue;
@@ -301,9 +294,9 @@ void options_print_help(options_t *this){
     char *short_form = (char *)dynmem_malloc(sizeof(char) * (short_form_len + 1));
     char *long_form = (char *)dynmem_malloc(sizeof(char) * (long_form_len + 1));
 
-    for(unsigned i = 0; i < list_count(this->options_configured); i++){
+    for(list_iter_begin(this->options_configured, &it); list_iter_valid(&it); list_iter_next(&it)){
         flag_t tmp;
-        list_at(this->options_configured, i, (void *)&tmp);
+        list_iter_get(&it, (void *)&tmp);
 
         memset((void *)short_form, '\0', short_form_len);
         memset((void *)long_form, '\0', long_form_len);
@@ -445,6 +438,24 @@ static void options_append(options_t *this, option_type_t type, options_arg_type
     new.short_form = short_form;
 
     list_append(this->options_configured, (void *)&new);
+
+    if(type == SECTION)
+        return;
+
+    //first configured flag wins, same as when flags were searched in list
+    if(long_form != NULL && !hashmap_contains(this->long_forms, (void *)&long_form))
+        hashmap_set(this->long_forms, (void *)&long_form, (void *)&new);
+
+    if(short_form != NULL && !hashmap_contains(this->short_forms, (void *)&short_form))
+        hashmap_set(this->short_forms, (void *)&short_form, (void *)&new);
+}
+
+static void options_set_given(options_t *this, set_option_t *option){
+    list_append(this->options_given, (void *)option);
+
+    //lookups return first given value
+    if(!hashmap_contains(this->given_values, (void *)&(option->flag)))
+        hashmap_set(this->given_values, (void *)&(option->flag), (void *)&(option->value));
 }
 
 static void print_auto_newline(FILE *FP, char *s, unsigned max_len, unsigned first_line_len, unsigned indentation, unsigned indentation_first_line){
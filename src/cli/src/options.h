@@ -26,6 +26,9 @@
 typedef struct {
     list_t *options_configured;
     list_t *options_given;
+    hashmap_t *long_forms;      /**< @brief Configured flags by long form. */
+    hashmap_t *short_forms;     /**< @brief Configured flags by short form. */
+    hashmap_t *given_values;    /**< @brief First value of each given flag by its name. */
     array_t *arguments_given;
     char *version;
     char *prog_name;
@@ -8,22 +8,19 @@
 #include <stdio.h>
 #include <string.h>
 
-static array_t *_new_array(size_t element_size, unsigned element_count);
+static array_t *_new_array(size_t element_size, unsigned element_count, dynmem_allocator_t *allocator);
 static void _free_array(array_t *array);
 static void _double_size(array_t *array);
 
 // -------------------------------------
 // Implementation of core functionality
 
-static array_t *_new_array(size_t element_size, unsigned element_count){
+static array_t *_new_array(size_t element_size, unsigned element_count, dynmem_allocator_t *allocator){
     array_t *tmp_array = NULL;
     void *tmp_data = NULL;
 
-    tmp_array = (array_t *)malloc(sizeof(array_t));
-    tmp_data = malloc(element_count * element_size);
-
-    dynmem_check_malloc(tmp_array);
-    dynmem_check_malloc(tmp_data);
+    tmp_array = (array_t *)dynmem_allocator_alloc(allocator, sizeof(array_t));
+    tmp_data = dynmem_allocator_alloc(allocator, element_count * element_size);
 
     memset(tmp_data, 0, element_count * element_size);
     memset(tmp_array, 0, sizeof(array_t));
@@ -31,23 +28,26 @@ static array_t *_new_array(size_t element_size, unsigned element_count){
     tmp_array->element_count = element_count;
     tmp_array->element_size = element_size;
     tmp_array->payload = tmp_data;
+    tmp_array->allocator = allocator;
 
     return tmp_array;
 }
 
 static void _free_array(array_t *array){
-    free(array->payload);
-    free(array);
+    dynmem_allocator_t *allocator = array->allocator;
+
+    dynmem_allocator_free(allocator, array->payload, array->element_count * array->element_size);
+    dynmem_allocator_free(allocator, array, sizeof(array_t));
 }
 
 static void _double_size(array_t *array){
     void *tmp_data = NULL;
 
+    size_t old_size = array->element_count * array->element_size;
     size_t new_count = array->element_count * 2;
     size_t new_size = new_count * array->element_size;
 
-    tmp_data = realloc(array->payload, new_size);
-    dynmem_check_malloc(tmp_data);
+    tmp_data = dynmem_allocator_realloc(array->allocator, array->payload, old_size, new_size);
 
     array->payload = tmp_data;
     array->element_count = new_count;
@@ -81,7 +81,18 @@ void array_init(array_t **ptr, size_t element_size, unsigned element_count){
     if(element_count == 0)
         error("You can't create new array with zero elements!");
 
-    *ptr = _new_array(element_size, element_count);
+    *ptr = _new_array(element_size, element_count, dynmem_allocator_default());
+}
+
+void array_init_allocator(array_t **ptr, size_t element_size, unsigned element_count, dynmem_allocator_t *allocator){
+    CHECK_NULL_ARGUMENT(ptr);
+    CHECK_NOT_NULL_ARGUMENT(*ptr);
+    CHECK_NULL_ARGUMENT(allocator);
+
+    if(element_count == 0)
+        error("You can't create new array with zero elements!");
+
+    *ptr = _new_array(element_size, element_count, allocator);
 }
 
 void array_destroy(array_t *ptr){
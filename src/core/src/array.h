@@ -48,6 +48,8 @@
 
 #include <stddef.h>
 
+#include "dynmem.h"
+
 /**
  * @brief Structure to hold array object.
  */
@@ -55,6 +57,7 @@ typedef struct{
     void *payload;              /**< @brief Pointer to raw data. */
     size_t element_size;        /**< @brief Size of one element in array. */
     unsigned element_count;     /**< @brief Actual size of array. */
+    dynmem_allocator_t *allocator;  /**< @brief Allocator used for array and its payload. */
 }array_t;
 
 /**
@@ -68,6 +71,16 @@ typedef struct{
  */
 extern void array_init(array_t **ptr, size_t element_size, unsigned element_count);
 
+/**
+ * @brief Initialize new empty array using given allocator.
+ *
+ * @param ptr Pointer that will be set with new array.
+ * @param element_size Size of one array item.
+ * @param element_count Size of array in element count.
+ * @param allocator Allocator used for array object and its data.
+ */
+extern void array_init_allocator(array_t **ptr, size_t element_size, unsigned element_count, dynmem_allocator_t *allocator);
+
 /**
  * @brief Deallocate memory used by array.
  *
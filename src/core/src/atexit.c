@@ -3,8 +3,10 @@
 #include "error.h"
 #include "list.h"
 #include "check.h"
+#include "dynmem.h"
 
 #include <stdlib.h>
+#include <stdio.h>
 #include <stdbool.h>
 
 typedef void atexit_signature(void);
@@ -23,6 +25,10 @@ void atexit_utillib_core_atexit(void){
     }
 
     stack_destroy(user_calls);
+
+#ifdef DYNMEM_STATS
+    dynmem_stats_report(stderr);
+#endif
 }
 
 void atexit_register(void (*f)(void)){
@@ -15,6 +15,9 @@
  * Ussage is pretty straightforward, simply call atexit_init() at the
  * begininning of your application and then use atexit_register().
  *
+ * If library is built with ENABLE_DYNMEM_STATS, report of allocations is
+ * printed to stderr after all registered functions (see dynmem_stats_report()).
+ *
  * @ingroup core_group
  *
  * @{
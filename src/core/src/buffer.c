@@ -11,10 +11,8 @@
 // -------------------------------------
 // Implementation of core functionality
 
-static inline buffer_t *_new_buffer(size_t element_size, unsigned element_count){
-    buffer_t *tmp_buffer = (buffer_t *)malloc(sizeof(buffer_t));
-
-    dynmem_check_malloc(tmp_buffer);
+static inline buffer_t *_new_buffer(size_t element_size, unsigned element_count, dynmem_allocator_t *allocator){
+    buffer_t *tmp_buffer = (buffer_t *)dynmem_allocator_alloc(allocator, sizeof(buffer_t));
 
     memset(tmp_buffer, 0, sizeof(buffer_t));
 
@@ -22,14 +20,16 @@ static inline buffer_t *_new_buffer(size_t element_size, unsigned element_count)
     tmp_buffer->head = 0;
     tmp_buffer->tail = 0;
 
-    array_init(&(tmp_buffer->buffer_array), element_size, element_count);
+    array_init_allocator(&(tmp_buffer->buffer_array), element_size, element_count, allocator);
 
     return tmp_buffer;
 }
 
 static inline void _free_buffer(buffer_t *ptr){
+    dynmem_allocator_t *allocator = ptr->buffer_array->allocator;
+
     array_destroy(ptr->buffer_array);
-    dynmem_free(ptr);
+    dynmem_allocator_free(allocator, ptr, sizeof(buffer_t));
 }
 
 static inline unsigned _capacity(buffer_t *ptr){
@@ -90,7 +90,21 @@ void buffer_init(buffer_t **ptr, size_t element_size, unsigned element_count){
     if(element_size == 0)
         error("You can't create new buffer with elements size zero!");
 
-    *ptr = _new_buffer(element_size, element_count + 1);
+    *ptr = _new_buffer(element_size, element_count + 1, dynmem_allocator_default());
+}
+
+void buffer_init_allocator(buffer_t **ptr, size_t element_size, unsigned element_count, dynmem_allocator_t *allocator){
+    CHECK_NULL_ARGUMENT(ptr);
+    CHECK_NOT_NULL_ARGUMENT(*ptr);
+    CHECK_NULL_ARGUMENT(allocator);
+
+    if(element_count == 0)
+        error("You can't create new buffer with zero elements!");
+
+    if(element_size == 0)
+        error("You can't create new buffer with elements size zero!");
+
+    *ptr = _new_buffer(element_size, element_count + 1, allocator);
 }
 
 void buffer_destroy(buffer_t *ptr){
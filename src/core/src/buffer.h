@@ -58,6 +58,16 @@ typedef struct{
  */
 extern void buffer_init(buffer_t **ptr, size_t element_size, unsigned element_count);
 
+/**
+ * @brief Initialize buffer object using given allocator.
+ *
+ * @param ptr Pointer to pointer where address of new buffer will be stored.
+ * @param element_size Size of one element in buffer (e.g. sizeof(uint8_t))
+ * @param element_count Count of element you want to store.
+ * @param allocator Allocator used for buffer object and its array.
+ */
+extern void buffer_init_allocator(buffer_t **ptr, size_t element_size, unsigned element_count, dynmem_allocator_t *allocator);
+
 /**
  * @brief Destroy previously initialized buffer.
  *
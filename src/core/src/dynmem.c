@@ -2,54 +2,622 @@
 
 #include "list.h"
 #include "error.h"
+#include "check.h"
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <string.h>
+#include <stdint.h>
+
+typedef union{
+    long double ld;
+    intmax_t im;
+    void *ptr;
+    void (*fn)(void);
+}_dynmem_align_t;
+
+#define DYNMEM_ALIGN(x) ((((x) + sizeof(_dynmem_align_t) - 1) / sizeof(_dynmem_align_t)) * sizeof(_dynmem_align_t))
+
+typedef struct dynmem_arena_chunk_s{
+    struct dynmem_arena_chunk_s *prev;
+    size_t size;
+    size_t used;
+}dynmem_arena_chunk_t;
+
+#define DYNMEM_ARENA_CHUNK_HEADER_SIZE DYNMEM_ALIGN(sizeof(dynmem_arena_chunk_t))
+
+#ifdef DYNMEM_STATS
+typedef struct{
+    dynmem_stats_site_t *site;
+    size_t size;
+}_dynmem_stats_header_t;
+
+#define DYNMEM_STATS_HEADER_SIZE DYNMEM_ALIGN(sizeof(_dynmem_stats_header_t))
+
+static dynmem_stats_t stats;
+static dynmem_stats_site_t sites[DYNMEM_STATS_MAX_SITES];
+static dynmem_stats_site_t *site_table[DYNMEM_STATS_MAX_SITES];
+static unsigned site_count = 0;
+
+static dynmem_stats_site_t *_stats_site(const char *file, unsigned line);
+static void _stats_add(dynmem_stats_site_t *site, size_t size);
+static void _stats_sub(dynmem_stats_site_t *site, size_t size);
+static int _stats_site_compare(const void *a, const void *b);
+#endif
+
+static void *_malloc(size_t size, const char *file, unsigned line);
+static void *_realloc(void *ptr, size_t new_size);
+static void _free(void *p);
+
+static dynmem_arena_chunk_t *_arena_new_chunk(dynmem_arena_chunk_t *prev, size_t size);
+static void _arena_free_until(dynmem_arena_t *arena, dynmem_arena_chunk_t *chunk);
+
+static void *_default_alloc(void *context, size_t size);
+static void *_default_realloc(void *context, void *ptr, size_t old_size, size_t new_size);
+static void _default_free(void *context, void *ptr, size_t size);
+
+static void *_arena_alloc(void *context, size_t size);
+static void *_arena_realloc(void *context, void *ptr, size_t old_size, size_t new_size);
+static void _arena_free(void *context, void *ptr, size_t size);
+
+static dynmem_allocator_t default_allocator = {
+    .alloc = _default_alloc,
+    .realloc = _default_realloc,
+    .free = _default_free,
+    .context = NULL
+};
+
+// -------------------------------------
+// Implementation of statistics
+
+#ifdef DYNMEM_STATS
+static dynmem_stats_site_t *_stats_site(const char *file, unsigned line){
+    //sites are hashed by address of file name, __FILE__ is same in one unit
+    size_t hash = ((uintptr_t)file >> 3) * 31 + line;
+    unsigned index = hash % DYNMEM_STATS_MAX_SITES;
+
+    for(unsigned i = 0; i < DYNMEM_STATS_MAX_SITES; i++){
+        dynmem_stats_site_t *tmp = site_table[index];
+
+        if(tmp == NULL){
+            //last slot is kept for unknown sites and overflow
+            if(site_count == DYNMEM_STATS_MAX_SITES - 1)
+                break;
+
+            tmp = &(sites[site_count++]);
+            tmp->file = file;
+            tmp->line = line;
+            site_table[index] = tmp;
+
+            return tmp;
+        }
+
+        if(tmp->file == file && tmp->line == line)
+            return tmp;
+
+        index = (index + 1) % DYNMEM_STATS_MAX_SITES;
+    }
+
+    return &(sites[DYNMEM_STATS_MAX_SITES - 1]);
+}
+
+static void _stats_add(dynmem_stats_site_t *site, size_t size){
+    stats.bytes_allocated += size;
+    stats.bytes_in_flight += size;
+    stats.blocks_in_flight++;
+
+    if(stats.bytes_in_flight > stats.peak_bytes)
+        stats.peak_bytes = stats.bytes_in_flight;
+
+    site->bytes_allocated += size;
+    site->bytes_in_flight += size;
+    site->blocks_in_flight++;
+}
+
+static void _stats_sub(dynmem_stats_site_t *site, size_t size){
+    stats.bytes_in_flight -= size;
+    stats.blocks_in_flight--;
+
+    site->bytes_in_flight -= size;
+    site->blocks_in_flight--;
+}
+
+static int _stats_site_compare(const void *a, const void *b){
+    const dynmem_stats_site_t *x = *(const dynmem_stats_site_t **)a;
+    const dynmem_stats_site_t *y = *(const dynmem_stats_site_t **)b;
+
+    if(x->bytes_allocated != y->bytes_allocated)
+        return (x->bytes_allocated < y->bytes_allocated) ? 1 : -1;
+
+    return 0;
+}
+#endif
+
+void dynmem_stats_snapshot(dynmem_stats_t *stats_out){
+    CHECK_NULL_ARGUMENT(stats_out);
+
+#ifdef DYNMEM_STATS
+    *stats_out = stats;
+#else
+    memset(stats_out, 0, sizeof(dynmem_stats_t));
+#endif
+}
+
+unsigned dynmem_stats_site_count(void){
+#ifdef DYNMEM_STATS
+    dynmem_stats_site_t *unknown = &(sites[DYNMEM_STATS_MAX_SITES - 1]);
+
+    if(unknown->allocations != 0 || unknown->blocks_in_flight != 0)
+        return site_count + 1;
+
+    return site_count;
+#else
+    return 0;
+#endif
+}
+
+void dynmem_stats_site(unsigned index, dynmem_stats_site_t *site){
+    CHECK_NULL_ARGUMENT(site);
+
+    if(index >= dynmem_stats_site_count())
+        error("Index of call site out of range!");
+
+#ifdef DYNMEM_STATS
+    //unknown site is last, but it is reported right after known sites
+    if(index == site_count)
+        index = DYNMEM_STATS_MAX_SITES - 1;
+
+    *site = sites[index];
+#endif
+}
+
+void dynmem_stats_reset(void){
+#ifdef DYNMEM_STATS
+    stats.allocations = 0;
+    stats.reallocations = 0;
+    stats.frees = 0;
+    stats.bytes_allocated = 0;
+    stats.peak_bytes = stats.bytes_in_flight;
+
+    for(unsigned i = 0; i < DYNMEM_STATS_MAX_SITES; i++){
+        sites[i].allocations = 0;
+        sites[i].bytes_allocated = 0;
+    }
+#endif
+}
+
+void dynmem_stats_report(FILE *stream){
+    CHECK_NULL_ARGUMENT(stream);
+
+#ifdef DYNMEM_STATS
+    static dynmem_stats_site_t *sorted[DYNMEM_STATS_MAX_SITES];
+    unsigned count = 0;
+
+    for(unsigned i = 0; i < DYNMEM_STATS_MAX_SITES; i++){
+        if(sites[i].allocations != 0 || sites[i].blocks_in_flight != 0)
+            sorted[count++] = &(sites[i]);
+    }
+
+    qsort(sorted, count, sizeof(dynmem_stats_site_t *), _stats_site_compare);
+
+    fprintf(stream, "dynmem: %zu allocations, %zu reallocations, %zu frees\n",
+        stats.allocations, stats.reallocations, stats.frees);
+    fprintf(stream, "dynmem: %zu bytes allocated, peak %zu bytes, %zu bytes in %zu blocks in flight\n",
+        stats.bytes_allocated, stats.peak_bytes, stats.bytes_in_flight, stats.blocks_in_flight);
+
+    for(unsigned i = 0; i < count; i++){
+        dynmem_stats_site_t *site = sorted[i];
+
+        fprintf(stream, "dynmem: %10zu allocations %12zu bytes %10zu in flight  %s:%u%s\n",
+            site->allocations, site->bytes_allocated, site->bytes_in_flight,
+            (site->file != NULL) ? site->file : "<unknown>", site->line,
+            (site->blocks_in_flight != 0) ? "  (not released)" : "");
+    }
+#else
+    fprintf(stream, "dynmem: statistics disabled, build with ENABLE_DYNMEM_STATS\n");
+#endif
+}
+
+// -------------------------------------
+// Implementation of core functionality
 
 void dynmem_check_malloc(void *p){
     if(p == NULL)
         error("Check malloc failed!");
 }
 
-void *dynmem_malloc(size_t size){
+static void *_malloc(size_t size, const char *file, unsigned line){
+#ifdef DYNMEM_STATS
+    _dynmem_stats_header_t *tmp = (_dynmem_stats_header_t *)malloc(DYNMEM_STATS_HEADER_SIZE + size);
+    dynmem_check_malloc(tmp);
+
+    tmp->site = (file != NULL) ? _stats_site(file, line) : &(sites[DYNMEM_STATS_MAX_SITES - 1]);
+    tmp->size = size;
+
+    stats.allocations++;
+    tmp->site->allocations++;
+    _stats_add(tmp->site, size);
+
+    return (void *)((char *)tmp + DYNMEM_STATS_HEADER_SIZE);
+#else
+    (void)file;
+    (void)line;
+
     void *tmp = malloc(size);
     dynmem_check_malloc(tmp);
     return tmp;
+#endif
+}
+
+static void *_realloc(void *ptr, size_t new_size){
+#ifdef DYNMEM_STATS
+    _dynmem_stats_header_t *tmp = (_dynmem_stats_header_t *)((char *)ptr - DYNMEM_STATS_HEADER_SIZE);
+    dynmem_stats_site_t *site = tmp->site;
+    size_t old_size = tmp->size;
+
+    tmp = (_dynmem_stats_header_t *)realloc((void *)tmp, DYNMEM_STATS_HEADER_SIZE + new_size);
+    dynmem_check_malloc(tmp);
+
+    tmp->size = new_size;
+
+    stats.reallocations++;
+    _stats_sub(site, old_size);
+    _stats_add(site, new_size);
+
+    return (void *)((char *)tmp + DYNMEM_STATS_HEADER_SIZE);
+#else
+    void *tmp = realloc(ptr, new_size);
+    dynmem_check_malloc(tmp);
+    return tmp;
+#endif
+}
+
+static void _free(void *p){
+#ifdef DYNMEM_STATS
+    _dynmem_stats_header_t *tmp = (_dynmem_stats_header_t *)((char *)p - DYNMEM_STATS_HEADER_SIZE);
+
+    stats.frees++;
+    _stats_sub(tmp->site, tmp->size);
+
+    free((void *)tmp);
+#else
+    free(p);
+#endif
 }
 
-void *dynmem_calloc(size_t num, size_t size){
+void *dynmem_malloc_at(size_t size, const char *file, unsigned line){
+    return _malloc(size, file, line);
+}
+
+void *dynmem_calloc_at(size_t num, size_t size, const char *file, unsigned line){
+#ifdef DYNMEM_STATS
+    if(size != 0 && num > SIZE_MAX / size)
+        error("Check malloc failed!");
+
+    void *tmp = _malloc(num * size, file, line);
+    memset(tmp, 0, num * size);
+    return tmp;
+#else
+    (void)file;
+    (void)line;
+
+    //calloc checks overflow itself and may get zeroed pages without memset
     void *tmp = calloc(num, size);
     dynmem_check_malloc(tmp);
     return tmp;
+#endif
 }
 
-void *dynmem_realloc(void *ptr, size_t new_size){
+void *dynmem_realloc_at(void *ptr, size_t new_size, const char *file, unsigned line){
+    (void)file;
+    (void)line;
+
     if(ptr == NULL)
         return NULL;
 
-    void *tmp = realloc(ptr, new_size);
+    return _realloc(ptr, new_size);
+}
+
+void dynmem_free_at(void *p, const char *file, unsigned line){
+    (void)file;
+    (void)line;
+
+    if(p == NULL)
+        return;
+
+    _free(p);
+}
+
+char *dynmem_strdup_at(char *s, const char *file, unsigned line){
+    if(s == NULL){
+        return NULL;
+    }
+
+    unsigned long len = strlen(s);
+    char *tmp = (char *)_malloc(len + 1, file, line);
+    memcpy((void *)tmp, (void *)s, len + 1);
+
+    return tmp;
+}
+
+//names are in parentheses, so macros of statistics don't expand here
+void *(dynmem_malloc)(size_t size){
+    return dynmem_malloc_at(size, NULL, 0);
+}
+
+void *(dynmem_calloc)(size_t num, size_t size){
+    return dynmem_calloc_at(num, size, NULL, 0);
+}
+
+void *(dynmem_realloc)(void *ptr, size_t new_size){
+    return dynmem_realloc_at(ptr, new_size, NULL, 0);
+}
+
+void (dynmem_free)(void *p){
+    dynmem_free_at(p, NULL, 0);
+}
+
+char *(dynmem_strdup)(char *s){
+    return dynmem_strdup_at(s, NULL, 0);
+}
+
+// -------------------------------------
+// Implementation of allocator interface
+
+static void *_default_alloc(void *context, size_t size){
+    (void)context;
+    return _malloc(size, NULL, 0);
+}
+
+static void *_default_realloc(void *context, void *ptr, size_t old_size, size_t new_size){
+    (void)context;
+    (void)old_size;
+    return _realloc(ptr, new_size);
+}
+
+static void _default_free(void *context, void *ptr, size_t size){
+    (void)context;
+    (void)size;
+    _free(ptr);
+}
+
+dynmem_allocator_t *dynmem_allocator_default(void){
+    return &default_allocator;
+}
+
+void *dynmem_allocator_alloc_at(dynmem_allocator_t *allocator, size_t size, const char *file, unsigned line){
+    CHECK_NULL_ARGUMENT(allocator);
+
+    //default allocator is called directly to keep call site of container
+    if(allocator == &default_allocator)
+        return _malloc(size, file, line);
+
+    void *tmp = allocator->alloc(allocator->context, size);
     dynmem_check_malloc(tmp);
 
     return tmp;
 }
 
-void dynmem_free(void *p){
-    if(p == NULL)
+void *dynmem_allocator_realloc_at(dynmem_allocator_t *allocator, void *ptr, size_t old_size, size_t new_size, const char *file, unsigned line){
+    CHECK_NULL_ARGUMENT(allocator);
+    CHECK_NULL_ARGUMENT(ptr);
+
+    (void)file;
+    (void)line;
+
+    void *tmp = allocator->realloc(allocator->context, ptr, old_size, new_size);
+    dynmem_check_malloc(tmp);
+
+    return tmp;
+}
+
+void dynmem_allocator_free_at(dynmem_allocator_t *allocator, void *ptr, size_t size, const char *file, unsigned line){
+    CHECK_NULL_ARGUMENT(allocator);
+
+    (void)file;
+    (void)line;
+
+    if(ptr == NULL)
         return;
 
-    free(p);
+    allocator->free(allocator->context, ptr, size);
+}
+
+void *(dynmem_allocator_alloc)(dynmem_allocator_t *allocator, size_t size){
+    return dynmem_allocator_alloc_at(allocator, size, NULL, 0);
+}
+
+void *(dynmem_allocator_realloc)(dynmem_allocator_t *allocator, void *ptr, size_t old_size, size_t new_size){
+    return dynmem_allocator_realloc_at(allocator, ptr, old_size, new_size, NULL, 0);
+}
+
+void (dynmem_allocator_free)(dynmem_allocator_t *allocator, void *ptr, size_t size){
+    dynmem_allocator_free_at(allocator, ptr, size, NULL, 0);
+}
+
+// -------------------------------------
+// Implementation of arenas
+
+static dynmem_arena_chunk_t *_arena_new_chunk(dynmem_arena_chunk_t *prev, size_t size){
+    dynmem_arena_chunk_t *tmp = (dynmem_arena_chunk_t *)dynmem_malloc(DYNMEM_ARENA_CHUNK_HEADER_SIZE + size);
+
+    tmp->prev = prev;
+    tmp->size = size;
+    tmp->used = 0;
+
+    return tmp;
+}
+
+static void _arena_free_until(dynmem_arena_t *arena, dynmem_arena_chunk_t *chunk){
+    while(arena->current != chunk){
+        dynmem_arena_chunk_t *tmp = arena->current;
+
+        if(tmp == NULL)
+            error("Arena mark doesn't belong to this arena!");
+
+        arena->current = tmp->prev;
+
+        //biggest chunk is kept, so repeated mark and rewind doesn't hit heap
+        if(arena->spare == NULL || arena->spare->size < tmp->size){
+            if(arena->spare != NULL)
+                dynmem_free(arena->spare);
+
+            arena->spare = tmp;
+        }
+        else{
+            dynmem_free(tmp);
+        }
+    }
+}
+
+void dynmem_arena_init(dynmem_arena_t **arena, size_t chunk_size){
+    CHECK_NULL_ARGUMENT(arena);
+    CHECK_NOT_NULL_ARGUMENT(*arena);
+
+    if(chunk_size == 0)
+        error("You can't create arena with chunk of size zero!");
+
+    dynmem_arena_t *tmp = (dynmem_arena_t *)dynmem_malloc(sizeof(dynmem_arena_t));
+
+    tmp->first = _arena_new_chunk(NULL, DYNMEM_ALIGN(chunk_size));
+    tmp->current = tmp->first;
+    tmp->spare = NULL;
+
+    tmp->allocator.alloc = _arena_alloc;
+    tmp->allocator.realloc = _arena_realloc;
+    tmp->allocator.free = _arena_free;
+    tmp->allocator.context = (void *)tmp;
+
+    *arena = tmp;
+}
+
+void dynmem_arena_destroy(dynmem_arena_t *arena){
+    CHECK_NULL_ARGUMENT(arena);
+
+    _arena_free_until(arena, NULL);
+
+    if(arena->spare != NULL)
+        dynmem_free(arena->spare);
+
+    dynmem_free(arena);
 }
 
-char *dynmem_strdup(char *s){
+void *dynmem_arena_malloc(dynmem_arena_t *arena, size_t size){
+    CHECK_NULL_ARGUMENT(arena);
+
+    dynmem_arena_chunk_t *chunk = arena->current;
+    size = DYNMEM_ALIGN(size);
+
+    if(chunk->size - chunk->used < size){
+        size_t new_size = chunk->size * 2;
+
+        while(new_size < size)
+            new_size *= 2;
+
+        if(arena->spare != NULL && arena->spare->size >= size){
+            arena->spare->prev = chunk;
+            arena->spare->used = 0;
+            chunk = arena->spare;
+            arena->spare = NULL;
+        }
+        else{
+            chunk = _arena_new_chunk(chunk, new_size);
+        }
+
+        arena->current = chunk;
+    }
+
+    void *tmp = (void *)((char *)chunk + DYNMEM_ARENA_CHUNK_HEADER_SIZE + chunk->used);
+    chunk->used += size;
+
+    return tmp;
+}
+
+void *dynmem_arena_calloc(dynmem_arena_t *arena, size_t num, size_t size){
+    if(size != 0 && num > SIZE_MAX / size)
+        error("Check malloc failed!");
+
+    void *tmp = dynmem_arena_malloc(arena, num * size);
+    memset(tmp, 0, num * size);
+    return tmp;
+}
+
+char *dynmem_arena_strdup(dynmem_arena_t *arena, char *s){
     if(s == NULL){
         return NULL;
     }
 
-    unsigned long len = strlen(s);
-    char *tmp = (char *)dynmem_calloc(len + 1, sizeof(char));
+    size_t len = strlen(s);
+    char *tmp = (char *)dynmem_arena_malloc(arena, len + 1);
     memcpy((void *)tmp, (void *)s, len + 1);
 
     return tmp;
 }
+
+void dynmem_arena_mark(dynmem_arena_t *arena, dynmem_arena_mark_t *mark){
+    CHECK_NULL_ARGUMENT(arena);
+    CHECK_NULL_ARGUMENT(mark);
+
+    mark->chunk = arena->current;
+    mark->used = arena->current->used;
+}
+
+void dynmem_arena_rewind(dynmem_arena_t *arena, dynmem_arena_mark_t *mark){
+    CHECK_NULL_ARGUMENT(arena);
+    CHECK_NULL_ARGUMENT(mark);
+
+    _arena_free_until(arena, mark->chunk);
+    arena->current->used = mark->used;
+}
+
+static inline bool _arena_is_last(dynmem_arena_t *arena, void *ptr, size_t size){
+    dynmem_arena_chunk_t *chunk = arena->current;
+    char *top = (char *)chunk + DYNMEM_ARENA_CHUNK_HEADER_SIZE + chunk->used;
+
+    return ((char *)ptr + DYNMEM_ALIGN(size) == top) ? true : false;
+}
+
+static void *_arena_alloc(void *context, size_t size){
+    return dynmem_arena_malloc((dynmem_arena_t *)context, size);
+}
+
+static void *_arena_realloc(void *context, void *ptr, size_t old_size, size_t new_size){
+    dynmem_arena_t *arena = (dynmem_arena_t *)context;
+    dynmem_arena_chunk_t *chunk = arena->current;
+
+    //last allocation can grow or shrink in place
+    if(_arena_is_last(arena, ptr, old_size)){
+        size_t start = chunk->used - DYNMEM_ALIGN(old_size);
+
+        if(chunk->size - start >= DYNMEM_ALIGN(new_size)){
+            chunk->used = start + DYNMEM_ALIGN(new_size);
+            return ptr;
+        }
+    }
+
+    void *tmp = dynmem_arena_malloc(arena, new_size);
+    memcpy(tmp, ptr, (old_size < new_size) ? old_size : new_size);
+
+    return tmp;
+}
+
+static void _arena_free(void *context, void *ptr, size_t size){
+    dynmem_arena_t *arena = (dynmem_arena_t *)context;
+
+    if(_arena_is_last(arena, ptr, size))
+        arena->current->used -= DYNMEM_ALIGN(size);
+}
+
+dynmem_allocator_t *dynmem_arena_allocator(dynmem_arena_t *arena){
+    CHECK_NULL_ARGUMENT(arena);
+
+    return &(arena->allocator);
+}
+
+void dynmem_arena_reset(dynmem_arena_t *arena){
+    CHECK_NULL_ARGUMENT(arena);
+
+    _arena_free_until(arena, arena->first);
+    arena->current->used = 0;
+}
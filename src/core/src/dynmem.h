@@ -3,6 +3,42 @@
  *
  * @brief Dynamic memory allocation with something like "garbage collector".
  *
+ * Functions dynmem_malloc(), dynmem_calloc() and others are wrappers around
+ * libc that will raise error instead of returning NULL.
+ *
+ * For many small allocations with the same lifetime there is arena allocator.
+ * Arena take memory from big chunks by simply moving pointer forward, single
+ * allocations are never freed. Instead, whole arena is released at once by
+ * dynmem_arena_reset() or returned to previously taken mark by
+ * dynmem_arena_rewind(). Biggest released chunk is kept for reuse, so arena
+ * that is filled and rewound over and over stops allocating after first round.
+ *
+ * @code{.c}
+ * dynmem_arena_t *arena = NULL;
+ * dynmem_arena_mark_t mark;
+ *
+ * dynmem_arena_init(&arena, DYNMEM_ARENA_DEFAULT_CHUNK_SIZE);
+ *
+ * dynmem_arena_mark(arena, &mark);
+ * char *s = dynmem_arena_strdup(arena, "temporary");
+ * dynmem_arena_rewind(arena, &mark);    //s is no longer valid
+ *
+ * dynmem_arena_destroy(arena);
+ * @endcode
+ *
+ * Containers (arrays, lists, buffers and strings) can be given an allocator
+ * at init time, see dynmem_allocator_t. Without it they use libc through
+ * dynmem_malloc() and friends. Allocator of arena is available by
+ * dynmem_arena_allocator().
+ *
+ * When library is built with ENABLE_DYNMEM_STATS option, all allocations done
+ * by dynmem (including containers using default allocator and arena chunks)
+ * are counted. Functions above are then replaced by macros remembering file
+ * and line of the call, so statistics can be split by call site. Counters are
+ * available by dynmem_stats_snapshot() and report is printed by
+ * dynmem_stats_report(), which is also called from atexit handler of
+ * utillib (see atexit_init()).
+ *
  * @todo missing documentation
  *
  * @ingroup core_group
@@ -14,6 +50,7 @@
 #define DYNMEM_H_included
 
 #include <stddef.h>
+#include <stdio.h>
 
 extern void dynmem_check_malloc(void *p);
 
@@ -24,6 +61,263 @@ extern void *dynmem_realloc(void *ptr, size_t new_size);
 extern void dynmem_free(void *p);
 
 extern char *dynmem_strdup(char *s);
+
+extern void *dynmem_malloc_at(size_t size, const char *file, unsigned line);
+extern void *dynmem_calloc_at(size_t num, size_t size, const char *file, unsigned line);
+extern void *dynmem_realloc_at(void *ptr, size_t new_size, const char *file, unsigned line);
+extern void dynmem_free_at(void *p, const char *file, unsigned line);
+extern char *dynmem_strdup_at(char *s, const char *file, unsigned line);
+
+/**
+ * @brief Allocator interface that can be attached to containers.
+ *
+ * All functions get context given in structure. Sizes of previous allocation
+ * are passed to realloc and free too, so simple allocators don't have to
+ * remember them.
+ */
+typedef struct{
+    void *(*alloc)(void *context, size_t size);     /**< @brief Allocate memory, return NULL on failure. */
+    void *(*realloc)(void *context, void *ptr, size_t old_size, size_t new_size);  /**< @brief Resize allocation. */
+    void (*free)(void *context, void *ptr, size_t size);    /**< @brief Release allocation. */
+    void *context;                                  /**< @brief User data given to all functions. */
+}dynmem_allocator_t;
+
+/**
+ * @brief Get allocator using libc, this is default for all containers.
+ *
+ * @return Pointer to static allocator object.
+ */
+extern dynmem_allocator_t *dynmem_allocator_default(void);
+
+/**
+ * @brief Allocate memory using given allocator.
+ *
+ * @param allocator Allocator object.
+ * @param size Count of bytes needed.
+ * @return Pointer to memory, error is raised if allocation fail.
+ */
+extern void *dynmem_allocator_alloc(dynmem_allocator_t *allocator, size_t size);
+
+/**
+ * @brief Resize memory using given allocator.
+ *
+ * @param allocator Allocator object.
+ * @param ptr Previously allocated memory.
+ * @param old_size Size of previous allocation.
+ * @param new_size New size.
+ * @return Pointer to memory, error is raised if allocation fail.
+ */
+extern void *dynmem_allocator_realloc(dynmem_allocator_t *allocator, void *ptr, size_t old_size, size_t new_size);
+
+/**
+ * @brief Release memory using given allocator.
+ *
+ * @param allocator Allocator object.
+ * @param ptr Previously allocated memory, can be NULL.
+ * @param size Size of allocation.
+ */
+extern void dynmem_allocator_free(dynmem_allocator_t *allocator, void *ptr, size_t size);
+
+extern void *dynmem_allocator_alloc_at(dynmem_allocator_t *allocator, size_t size, const char *file, unsigned line);
+extern void *dynmem_allocator_realloc_at(dynmem_allocator_t *allocator, void *ptr, size_t old_size, size_t new_size, const char *file, unsigned line);
+extern void dynmem_allocator_free_at(dynmem_allocator_t *allocator, void *ptr, size_t size, const char *file, unsigned line);
+
+/**
+ * @brief Default size of arena chunk in bytes.
+ */
+#ifndef DYNMEM_ARENA_DEFAULT_CHUNK_SIZE
+#define DYNMEM_ARENA_DEFAULT_CHUNK_SIZE 4096
+#endif
+
+/**
+ * @brief Arena object.
+ */
+typedef struct{
+    struct dynmem_arena_chunk_s *first;     /**< @brief Chunk allocated at init, never freed before destroy. */
+    struct dynmem_arena_chunk_s *current;   /**< @brief Chunk allocations are taken from. */
+    struct dynmem_arena_chunk_s *spare;     /**< @brief Biggest released chunk kept for reuse or NULL. */
+    dynmem_allocator_t allocator;           /**< @brief Allocator interface of this arena. */
+}dynmem_arena_t;
+
+/**
+ * @brief Position in arena, see dynmem_arena_mark().
+ */
+typedef struct{
+    struct dynmem_arena_chunk_s *chunk;
+    size_t used;
+}dynmem_arena_mark_t;
+
+/**
+ * @brief Create new arena.
+ *
+ * @param arena Pointer to pointer to NULL where new arena will be stored.
+ * @param chunk_size Size of first chunk in bytes, following chunks are growing.
+ */
+extern void dynmem_arena_init(dynmem_arena_t **arena, size_t chunk_size);
+
+/**
+ * @brief Free arena and all memory allocated from it.
+ *
+ * @param arena Arena object.
+ */
+extern void dynmem_arena_destroy(dynmem_arena_t *arena);
+
+/**
+ * @brief Allocate memory from arena.
+ *
+ * @param arena Arena object.
+ * @param size Count of bytes needed.
+ * @return Pointer to memory aligned for any type.
+ */
+extern void *dynmem_arena_malloc(dynmem_arena_t *arena, size_t size);
+
+/**
+ * @brief Allocate zeroed memory from arena.
+ *
+ * @param arena Arena object.
+ * @param num Count of elements.
+ * @param size Size of one element.
+ * @return Pointer to memory aligned for any type.
+ */
+extern void *dynmem_arena_calloc(dynmem_arena_t *arena, size_t num, size_t size);
+
+/**
+ * @brief Copy string into arena.
+ *
+ * @param arena Arena object.
+ * @param s String to copy, can be NULL.
+ * @return Copy of string or NULL.
+ */
+extern char *dynmem_arena_strdup(dynmem_arena_t *arena, char *s);
+
+/**
+ * @brief Remember current position of arena.
+ *
+ * @param arena Arena object.
+ * @param mark Where position will be stored.
+ */
+extern void dynmem_arena_mark(dynmem_arena_t *arena, dynmem_arena_mark_t *mark);
+
+/**
+ * @brief Release everything allocated since mark was taken.
+ *
+ * @param arena Arena object.
+ * @param mark Position taken by dynmem_arena_mark().
+ */
+extern void dynmem_arena_rewind(dynmem_arena_t *arena, dynmem_arena_mark_t *mark);
+
+/**
+ * @brief Get allocator interface of arena.
+ *
+ * Freeing through this allocator release memory only if it is the last
+ * allocation of arena, otherwise it is kept until arena is rewound.
+ *
+ * @param arena Arena object.
+ * @return Allocator valid as long as arena exist.
+ */
+extern dynmem_allocator_t *dynmem_arena_allocator(dynmem_arena_t *arena);
+
+/**
+ * @brief Release everything allocated from arena.
+ *
+ * @note First chunk and the biggest of released chunks are kept, others
+ * are freed.
+ *
+ * @param arena Arena object.
+ */
+extern void dynmem_arena_reset(dynmem_arena_t *arena);
+
+/**
+ * @brief Maximal count of call sites tracked separately.
+ *
+ * Allocations from other sites are counted into site without file.
+ */
+#ifndef DYNMEM_STATS_MAX_SITES
+#define DYNMEM_STATS_MAX_SITES 512
+#endif
+
+/**
+ * @brief Global allocation counters.
+ */
+typedef struct{
+    size_t allocations;         /**< @brief Count of allocations. */
+    size_t reallocations;       /**< @brief Count of reallocations. */
+    size_t frees;               /**< @brief Count of released blocks. */
+    size_t bytes_allocated;     /**< @brief Sum of all requested sizes. */
+    size_t bytes_in_flight;     /**< @brief Bytes allocated and not yet released. */
+    size_t blocks_in_flight;    /**< @brief Blocks allocated and not yet released. */
+    size_t peak_bytes;          /**< @brief Maximum of bytes_in_flight. */
+}dynmem_stats_t;
+
+/**
+ * @brief Allocation counters of one call site.
+ */
+typedef struct{
+    const char *file;           /**< @brief Source file or NULL if site is unknown. */
+    unsigned line;              /**< @brief Line in source file. */
+    size_t allocations;         /**< @brief Count of allocations done here. */
+    size_t bytes_allocated;     /**< @brief Sum of sizes allocated here. */
+    size_t bytes_in_flight;     /**< @brief Bytes allocated here and not yet released. */
+    size_t blocks_in_flight;    /**< @brief Blocks allocated here and not yet released. */
+}dynmem_stats_site_t;
+
+/**
+ * @brief Copy current global counters.
+ *
+ * @note Without ENABLE_DYNMEM_STATS all counters are zero.
+ *
+ * @param stats Where counters will be stored.
+ */
+extern void dynmem_stats_snapshot(dynmem_stats_t *stats);
+
+/**
+ * @brief Get count of call sites seen so far.
+ *
+ * @return Count of sites, valid indexes for dynmem_stats_site().
+ */
+extern unsigned dynmem_stats_site_count(void);
+
+/**
+ * @brief Copy counters of one call site.
+ *
+ * @param index Index of site lower than dynmem_stats_site_count().
+ * @param site Where counters will be stored.
+ */
+extern void dynmem_stats_site(unsigned index, dynmem_stats_site_t *site);
+
+/**
+ * @brief Reset counters.
+ *
+ * Counts of allocations are set to zero, peak is set to bytes in flight.
+ * Blocks allocated before reset are still tracked, so they are correctly
+ * subtracted when they are released.
+ */
+extern void dynmem_stats_reset(void);
+
+/**
+ * @brief Print counters and call sites sorted by allocated bytes.
+ *
+ * Sites with blocks in flight are marked, at exit these are leaks.
+ *
+ * @param stream Output stream.
+ */
+extern void dynmem_stats_report(FILE *stream);
+
+#ifdef DYNMEM_STATS
+#define dynmem_malloc(size) dynmem_malloc_at((size), __FILE__, __LINE__)
+#define dynmem_calloc(num, size) dynmem_calloc_at((num), (size), __FILE__, __LINE__)
+#define dynmem_realloc(ptr, new_size) dynmem_realloc_at((ptr), (new_size), __FILE__, __LINE__)
+#define dynmem_free(p) dynmem_free_at((p), __FILE__, __LINE__)
+#define dynmem_strdup(s) dynmem_strdup_at((s), __FILE__, __LINE__)
+
+#define dynmem_allocator_alloc(allocator, size) \
+    dynmem_allocator_alloc_at((allocator), (size), __FILE__, __LINE__)
+#define dynmem_allocator_realloc(allocator, ptr, old_size, new_size) \
+    dynmem_allocator_realloc_at((allocator), (ptr), (old_size), (new_size), __FILE__, __LINE__)
+#define dynmem_allocator_free(allocator, ptr, size) \
+    dynmem_allocator_free_at((allocator), (ptr), (size), __FILE__, __LINE__)
+#endif
+
 #endif
 
 /**
@@ -0,0 +1,386 @@
+#include "hashmap.h"
+
+#include "string_view.h"
+#include "error.h"
+#include "check.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#define HASHMAP_MIN_CAPACITY 8
+
+typedef union{
+    long double ld;
+    intmax_t im;
+    void *ptr;
+    void (*fn)(void);
+}_hashmap_align_t;
+
+#define HASHMAP_ALIGN(x) ((((x) + sizeof(_hashmap_align_t) - 1) / sizeof(_hashmap_align_t)) * sizeof(_hashmap_align_t))
+
+//distance is length of probe sequence plus one, zero mark empty slot
+typedef struct{
+    uint32_t hash;
+    uint32_t distance;
+}hashmap_slot_header_t;
+
+static hashmap_t *_new_hashmap(size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal, dynmem_allocator_t *allocator);
+static inline hashmap_slot_header_t *_slot(hashmap_t *map, unsigned index);
+static inline void *_slot_key(hashmap_t *map, hashmap_slot_header_t *slot);
+static inline void *_slot_value(hashmap_t *map, hashmap_slot_header_t *slot);
+static void *_alloc_slots(hashmap_t *map, unsigned capacity);
+static void _swap_slot(hashmap_t *map, hashmap_slot_header_t *slot);
+static void _place(hashmap_t *map);
+static long _find(hashmap_t *map, const void *key, uint32_t hash);
+
+// -------------------------------------
+// Implementation of core functionality
+
+static hashmap_t *_new_hashmap(size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal, dynmem_allocator_t *allocator){
+    hashmap_t *tmp = (hashmap_t *)dynmem_allocator_alloc(allocator, sizeof(hashmap_t));
+
+    tmp->key_size = key_size;
+    tmp->value_size = value_size;
+    tmp->key_offset = HASHMAP_ALIGN(sizeof(hashmap_slot_header_t));
+    tmp->value_offset = tmp->key_offset + HASHMAP_ALIGN(key_size);
+    tmp->slot_size = tmp->value_offset + HASHMAP_ALIGN(value_size);
+    tmp->hash = (hash != NULL) ? hash : hashmap_hash_bytes;
+    tmp->equal = (equal != NULL) ? equal : hashmap_equal_bytes;
+    tmp->allocator = allocator;
+    tmp->count = 0;
+    tmp->capacity = HASHMAP_MIN_CAPACITY;
+    tmp->slots = _alloc_slots(tmp, tmp->capacity);
+    tmp->scratch = dynmem_allocator_alloc(allocator, tmp->slot_size);
+
+    return tmp;
+}
+
+static inline hashmap_slot_header_t *_slot(hashmap_t *map, unsigned index){
+    return (hashmap_slot_header_t *)((char *)map->slots + (size_t)index * map->slot_size);
+}
+
+static inline void *_slot_key(hashmap_t *map, hashmap_slot_header_t *slot){
+    return (void *)((char *)slot + map->key_offset);
+}
+
+static inline void *_slot_value(hashmap_t *map, hashmap_slot_header_t *slot){
+    return (void *)((char *)slot + map->value_offset);
+}
+
+static void *_alloc_slots(hashmap_t *map, unsigned capacity){
+    size_t size = (size_t)capacity * map->slot_size;
+    void *tmp = dynmem_allocator_alloc(map->allocator, size);
+
+    memset(tmp, 0, size);
+
+    return tmp;
+}
+
+static void _swap_slot(hashmap_t *map, hashmap_slot_header_t *slot){
+    unsigned char *a = (unsigned char *)slot;
+    unsigned char *b = (unsigned char *)map->scratch;
+
+    for(size_t i = 0; i < map->slot_size; i++){
+        unsigned char tmp = a[i];
+        a[i] = b[i];
+        b[i] = tmp;
+    }
+}
+
+//put slot prepared in scratch into table, key must not be in table yet
+static void _place(hashmap_t *map){
+    hashmap_slot_header_t *entry = (hashmap_slot_header_t *)map->scratch;
+    unsigned mask = map->capacity - 1;
+    unsigned index = entry->hash & mask;
+
+    entry->distance = 1;
+
+    while(true){
+        hashmap_slot_header_t *slot = _slot(map, index);
+
+        if(slot->distance == 0){
+            memcpy(slot, entry, map->slot_size);
+            map->count++;
+            return;
+        }
+
+        //take slot from entry that is closer to its home
+        if(slot->distance < entry->distance)
+            _swap_slot(map, slot);
+
+        entry->distance++;
+        index = (index + 1) & mask;
+    }
+}
+
+static long _find(hashmap_t *map, const void *key, uint32_t hash){
+    unsigned mask = map->capacity - 1;
+    unsigned index = hash & mask;
+    uint32_t distance = 1;
+
+    while(true){
+        hashmap_slot_header_t *slot = _slot(map, index);
+
+        //entries are ordered by distance, key can't be further
+        if(slot->distance < distance)
+            return -1;
+
+        if(slot->hash == hash && map->equal(_slot_key(map, slot), key, map->key_size))
+            return (long)index;
+
+        distance++;
+        index = (index + 1) & mask;
+    }
+}
+
+// -------------------------------------
+// Implementation of hash maps
+
+void hashmap_init(hashmap_t **map, size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal){
+    hashmap_init_allocator(map, key_size, value_size, hash, equal, dynmem_allocator_default());
+}
+
+void hashmap_init_allocator(hashmap_t **map, size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal, dynmem_allocator_t *allocator){
+    CHECK_NULL_ARGUMENT(map);
+    CHECK_NOT_NULL_ARGUMENT(*map);
+    CHECK_NULL_ARGUMENT(allocator);
+
+    if(key_size == 0)
+        error("You can't create hash map with key of size zero!");
+
+    *map = _new_hashmap(key_size, value_size, hash, equal, allocator);
+}
+
+void hashmap_destroy(hashmap_t *map){
+    CHECK_NULL_ARGUMENT(map);
+
+    dynmem_allocator_t *allocator = map->allocator;
+
+    dynmem_allocator_free(allocator, map->scratch, map->slot_size);
+    dynmem_allocator_free(allocator, map->slots, (size_t)map->capacity * map->slot_size);
+    dynmem_allocator_free(allocator, map, sizeof(hashmap_t));
+}
+
+bool hashmap_set(hashmap_t *map, const void *key, const void *value){
+    CHECK_NULL_ARGUMENT(map);
+    CHECK_NULL_ARGUMENT(key);
+
+    if(value == NULL && map->value_size != 0)
+        error("Value can be NULL only for map with value of size zero!");
+
+    uint32_t hash = map->hash(key, map->key_size);
+    long index = _find(map, key, hash);
+
+    if(index >= 0){
+        if(map->value_size != 0)
+            memcpy(_slot_value(map, _slot(map, (unsigned)index)), value, map->value_size);
+
+        return false;
+    }
+
+    //keep load under 7/8
+    if((size_t)(map->count + 1) * 8 > (size_t)map->capacity * 7)
+        hashmap_rehash(map, map->capacity * 2);
+
+    hashmap_slot_header_t *entry = (hashmap_slot_header_t *)map->scratch;
+    entry->hash = hash;
+    memcpy(_slot_key(map, entry), key, map->key_size);
+
+    if(map->value_size != 0)
+        memcpy(_slot_value(map, entry), value, map->value_size);
+
+    _place(map);
+
+    return true;
+}
+
+bool hashmap_get(hashmap_t *map, const void *key, void *value){
+    void *tmp = hashmap_at(map, key);
+
+    if(tmp == NULL)
+        return false;
+
+    if(value != NULL && map->value_size != 0)
+        memcpy(value, tmp, map->value_size);
+
+    return true;
+}
+
+void *hashmap_at(hashmap_t *map, const void *key){
+    CHECK_NULL_ARGUMENT(map);
+    CHECK_NULL_ARGUMENT(key);
+
+    long index = _find(map, key, map->hash(key, map->key_size));
+
+    if(index < 0)
+        return NULL;
+
+    return _slot_value(map, _slot(map, (unsigned)index));
+}
+
+bool hashmap_contains(hashmap_t *map, const void *key){
+    return (hashmap_at(map, key) != NULL) ? true : false;
+}
+
+bool hashmap_remove(hashmap_t *map, const void *key){
+    CHECK_NULL_ARGUMENT(map);
+    CHECK_NULL_ARGUMENT(key);
+
+    long found = _find(map, key, map->hash(key, map->key_size));
+
+    if(found < 0)
+        return false;
+
+    //shift following entries back, so no tombstones are needed
+    unsigned mask = map->capacity - 1;
+    unsigned index = (unsigned)found;
+    unsigned next = (index + 1) & mask;
+
+    while(_slot(map, next)->distance > 1){
+        memcpy(_slot(map, index), _slot(map, next), map->slot_size);
+        _slot(map, index)->distance--;
+
+        index = next;
+        next = (next + 1) & mask;
+    }
+
+    _slot(map, index)->distance = 0;
+    map->count--;
+
+    return true;
+}
+
+void hashmap_clear(hashmap_t *map){
+    CHECK_NULL_ARGUMENT(map);
+
+    for(unsigned i = 0; i < map->capacity; i++)
+        _slot(map, i)->distance = 0;
+
+    map->count = 0;
+}
+
+unsigned hashmap_count(hashmap_t *map){
+    CHECK_NULL_ARGUMENT(map);
+
+    return map->count;
+}
+
+void hashmap_reserve(hashmap_t *map, unsigned count){
+    CHECK_NULL_ARGUMENT(map);
+
+    if((size_t)count * 8 > (size_t)map->capacity * 7)
+        hashmap_rehash(map, (unsigned)(((size_t)count * 8 + 6) / 7));
+}
+
+void hashmap_rehash(hashmap_t *map, unsigned capacity){
+    CHECK_NULL_ARGUMENT(map);
+
+    unsigned new_capacity = HASHMAP_MIN_CAPACITY;
+
+    while(new_capacity < capacity || (size_t)map->count * 8 > (size_t)new_capacity * 7){
+        if(new_capacity > UINT32_MAX / 2)
+            error("Hash map is too large!");
+
+        new_capacity *= 2;
+    }
+
+    void *old_slots = map->slots;
+    unsigned old_capacity = map->capacity;
+
+    map->slots = _alloc_slots(map, new_capacity);
+    map->capacity = new_capacity;
+    map->count = 0;
+
+    //hashes are stored in slots, keys are not hashed again
+    for(unsigned i = 0; i < old_capacity; i++){
+        hashmap_slot_header_t *slot = (hashmap_slot_header_t *)((char *)old_slots + (size_t)i * map->slot_size);
+
+        if(slot->distance == 0)
+            continue;
+
+        memcpy(map->scratch, slot, map->slot_size);
+        _place(map);
+    }
+
+    dynmem_allocator_free(map->allocator, old_slots, (size_t)old_capacity * map->slot_size);
+}
+
+void hashmap_iter_begin(hashmap_t *map, hashmap_iter_t *it){
+    CHECK_NULL_ARGUMENT(map);
+    CHECK_NULL_ARGUMENT(it);
+
+    it->map = map;
+    it->index = 0;
+
+    while(it->index < map->capacity && _slot(map, it->index)->distance == 0)
+        it->index++;
+}
+
+bool hashmap_iter_valid(hashmap_iter_t *it){
+    CHECK_NULL_ARGUMENT(it);
+
+    return (it->index < it->map->capacity) ? true : false;
+}
+
+void hashmap_iter_next(hashmap_iter_t *it){
+    CHECK_NULL_ARGUMENT(it);
+
+    if(it->index >= it->map->capacity)
+        error("Called next on invalid hash map iterator!");
+
+    it->index++;
+
+    while(it->index < it->map->capacity && _slot(it->map, it->index)->distance == 0)
+        it->index++;
+}
+
+const void *hashmap_iter_key(hashmap_iter_t *it){
+    CHECK_NULL_ARGUMENT(it);
+
+    if(it->index >= it->map->capacity)
+        error("Called key on invalid hash map iterator!");
+
+    return _slot_key(it->map, _slot(it->map, it->index));
+}
+
+void *hashmap_iter_value(hashmap_iter_t *it){
+    CHECK_NULL_ARGUMENT(it);
+
+    if(it->index >= it->map->capacity)
+        error("Called value on invalid hash map iterator!");
+
+    return _slot_value(it->map, _slot(it->map, it->index));
+}
+
+// -------------------------------------
+// Implementation of hash and equality functions
+
+uint32_t hashmap_hash_bytes(const void *key, size_t key_size){
+    //same FNV-1a as for strings, bytes of key are viewed as chars
+    return string_view_hash(string_view_make((const char *)key, key_size));
+}
+
+bool hashmap_equal_bytes(const void *a, const void *b, size_t key_size){
+    return (memcmp(a, b, key_size) == 0) ? true : false;
+}
+
+uint32_t hashmap_hash_cstr(const void *key, size_t key_size){
+    (void)key_size;
+    return string_view_hash(string_view_from(*(const char **)key));
+}
+
+bool hashmap_equal_cstr(const void *a, const void *b, size_t key_size){
+    (void)key_size;
+    return (strcmp(*(const char **)a, *(const char **)b) == 0) ? true : false;
+}
+
+uint32_t hashmap_hash_view(const void *key, size_t key_size){
+    (void)key_size;
+    return string_view_hash(*(const string_view_t *)key);
+}
+
+bool hashmap_equal_view(const void *a, const void *b, size_t key_size){
+    (void)key_size;
+    return string_view_equal(*(const string_view_t *)a, *(const string_view_t *)b);
+}
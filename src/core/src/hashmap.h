@@ -0,0 +1,283 @@
+/**
+ * @defgroup hashmap_group Hash maps
+ *
+ * @brief Associative container with keys and values of given size.
+ *
+ * Like arrays, hash map copy keys and values of size given at init time.
+ * Keys are compared by callbacks, for raw bytes of key (e.g. integers) there
+ * are hashmap_hash_bytes() and hashmap_equal_bytes(), which are used when
+ * NULL is given. For keys that are zero terminated strings (key is char *)
+ * use hashmap_hash_cstr() and hashmap_equal_cstr(), for keys that are
+ * string_view_t use hashmap_hash_view() and hashmap_equal_view().
+ *
+ * Map use open addressing with Robin Hood probing, so lookups have short
+ * and predictable probe sequences even with high load. Count of slots is
+ * always power of two and map grows when it is filled to 7/8.
+ *
+ * @code{.c}
+ * hashmap_t *map = NULL;
+ * char *key = "answer";
+ * int value = 42;
+ *
+ * hashmap_init(&map, sizeof(char *), sizeof(int), hashmap_hash_cstr, hashmap_equal_cstr);
+ * hashmap_set(map, &key, &value);
+ *
+ * if(hashmap_get(map, &key, &value)){
+ *     //found
+ * }
+ *
+ * hashmap_destroy(map);
+ * @endcode
+ *
+ * @note Pointers returned by hashmap_at() and iterators are valid only until
+ * map is modified.
+ *
+ * @ingroup core_group
+ *
+ * @{
+ */
+
+#ifndef HASHMAP_H_included
+#define HASHMAP_H_included
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dynmem.h"
+
+/**
+ * @brief Hash function for keys.
+ *
+ * @param key Pointer to key.
+ * @param key_size Size of key given at init.
+ * @return Hash of key.
+ */
+typedef uint32_t (*hashmap_hash_t)(const void *key, size_t key_size);
+
+/**
+ * @brief Equality function for keys.
+ *
+ * @param a Pointer to first key.
+ * @param b Pointer to second key.
+ * @param key_size Size of key given at init.
+ * @return true if keys are equal.
+ */
+typedef bool (*hashmap_equal_t)(const void *a, const void *b, size_t key_size);
+
+/**
+ * @brief Structure to hold hash map object.
+ */
+typedef struct{
+    void *slots;                /**< @brief Raw slots, each have header, key and value. */
+    void *scratch;              /**< @brief Space for one slot used while inserting. */
+    size_t key_size;            /**< @brief Size of key. */
+    size_t value_size;          /**< @brief Size of value. */
+    size_t key_offset;          /**< @brief Offset of key in slot. */
+    size_t value_offset;        /**< @brief Offset of value in slot. */
+    size_t slot_size;           /**< @brief Size of one slot. */
+    unsigned capacity;          /**< @brief Count of slots, power of two. */
+    unsigned count;             /**< @brief Count of stored keys. */
+    hashmap_hash_t hash;        /**< @brief Hash function. */
+    hashmap_equal_t equal;      /**< @brief Equality function. */
+    dynmem_allocator_t *allocator;  /**< @brief Allocator used for map and its slots. */
+}hashmap_t;
+
+/**
+ * @brief Position in hash map.
+ */
+typedef struct{
+    hashmap_t *map;             /**< @brief Map iterated over. */
+    unsigned index;             /**< @brief Current slot. */
+}hashmap_iter_t;
+
+/**
+ * @brief Initialize new empty hash map.
+ *
+ * @param map Pointer that will be set with new map.
+ * @param key_size Size of key.
+ * @param value_size Size of value, can be zero when map is used as set.
+ * @param hash Hash function or NULL to hash raw bytes of key.
+ * @param equal Equality function or NULL to compare raw bytes of key.
+ */
+extern void hashmap_init(hashmap_t **map, size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal);
+
+/**
+ * @brief Initialize new empty hash map using given allocator.
+ *
+ * @param map Pointer that will be set with new map.
+ * @param key_size Size of key.
+ * @param value_size Size of value, can be zero when map is used as set.
+ * @param hash Hash function or NULL to hash raw bytes of key.
+ * @param equal Equality function or NULL to compare raw bytes of key.
+ * @param allocator Allocator used for map object and its slots.
+ */
+extern void hashmap_init_allocator(hashmap_t **map, size_t key_size, size_t value_size, hashmap_hash_t hash, hashmap_equal_t equal, dynmem_allocator_t *allocator);
+
+/**
+ * @brief Destroy hash map.
+ *
+ * @param map Map object.
+ */
+extern void hashmap_destroy(hashmap_t *map);
+
+/**
+ * @brief Insert key or replace value of existing key.
+ *
+ * @param map Map object.
+ * @param key Pointer to key, it is copied.
+ * @param value Pointer to value, it is copied. Can be NULL if value size is zero.
+ * @return true Key was inserted.
+ * @return false Key already existed, value was replaced.
+ */
+extern bool hashmap_set(hashmap_t *map, const void *key, const void *value);
+
+/**
+ * @brief Copy value of key.
+ *
+ * @param map Map object.
+ * @param key Pointer to key.
+ * @param value Where value will be copied, can be NULL.
+ * @return true Key was found.
+ * @return false Key isn't in map, value is untouched.
+ */
+extern bool hashmap_get(hashmap_t *map, const void *key, void *value);
+
+/**
+ * @brief Get pointer to value of key.
+ *
+ * @param map Map object.
+ * @param key Pointer to key.
+ * @return Pointer to value stored in map or NULL if key isn't in map.
+ */
+extern void *hashmap_at(hashmap_t *map, const void *key);
+
+/**
+ * @brief Check if key is in map.
+ *
+ * @param map Map object.
+ * @param key Pointer to key.
+ * @return true Key is in map.
+ * @return false Key isn't in map.
+ */
+extern bool hashmap_contains(hashmap_t *map, const void *key);
+
+/**
+ * @brief Remove key from map.
+ *
+ * @param map Map object.
+ * @param key Pointer to key.
+ * @return true Key was removed.
+ * @return false Key wasn't in map.
+ */
+extern bool hashmap_remove(hashmap_t *map, const void *key);
+
+/**
+ * @brief Remove all keys, allocated slots are kept.
+ *
+ * @param map Map object.
+ */
+extern void hashmap_clear(hashmap_t *map);
+
+/**
+ * @brief Get count of keys.
+ *
+ * @param map Map object.
+ * @return Count of keys in map.
+ */
+extern unsigned hashmap_count(hashmap_t *map);
+
+/**
+ * @brief Make sure given count of keys fits in map without rehashing.
+ *
+ * @param map Map object.
+ * @param count Count of keys.
+ */
+extern void hashmap_reserve(hashmap_t *map, unsigned count);
+
+/**
+ * @brief Rebuild map with given count of slots.
+ *
+ * @param map Map object.
+ * @param capacity Wanted count of slots, it is rounded up to power of two and
+ * enlarged if current keys wouldn't fit.
+ */
+extern void hashmap_rehash(hashmap_t *map, unsigned capacity);
+
+/**
+ * @brief Set iterator to first key of map.
+ *
+ * @note Order of keys is not specified.
+ *
+ * @param map Map object.
+ * @param it Iterator to be set.
+ */
+extern void hashmap_iter_begin(hashmap_t *map, hashmap_iter_t *it);
+
+/**
+ * @brief Check if iterator points to key.
+ *
+ * @param it Iterator.
+ * @return true Iterator points to key.
+ * @return false Iterator is past the last key.
+ */
+extern bool hashmap_iter_valid(hashmap_iter_t *it);
+
+/**
+ * @brief Move iterator to next key.
+ *
+ * @param it Valid iterator.
+ */
+extern void hashmap_iter_next(hashmap_iter_t *it);
+
+/**
+ * @brief Get pointer to key iterator points to.
+ *
+ * @param it Valid iterator.
+ * @return Pointer to key stored in map, don't modify it.
+ */
+extern const void *hashmap_iter_key(hashmap_iter_t *it);
+
+/**
+ * @brief Get pointer to value iterator points to.
+ *
+ * @param it Valid iterator.
+ * @return Pointer to value stored in map.
+ */
+extern void *hashmap_iter_value(hashmap_iter_t *it);
+
+/**
+ * @brief Hash raw bytes of key (FNV-1a).
+ */
+extern uint32_t hashmap_hash_bytes(const void *key, size_t key_size);
+
+/**
+ * @brief Compare raw bytes of keys.
+ */
+extern bool hashmap_equal_bytes(const void *a, const void *b, size_t key_size);
+
+/**
+ * @brief Hash key that is pointer to zero terminated string (char *).
+ */
+extern uint32_t hashmap_hash_cstr(const void *key, size_t key_size);
+
+/**
+ * @brief Compare keys that are pointers to zero terminated strings (char *).
+ */
+extern bool hashmap_equal_cstr(const void *a, const void *b, size_t key_size);
+
+/**
+ * @brief Hash key that is string_view_t.
+ */
+extern uint32_t hashmap_hash_view(const void *key, size_t key_size);
+
+/**
+ * @brief Compare keys that are string_view_t.
+ */
+extern bool hashmap_equal_view(const void *a, const void *b, size_t key_size);
+
+#endif
+
+/**
+ * @}
+ */
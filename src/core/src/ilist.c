@@ -0,0 +1,149 @@
+#include "ilist.h"
+
+#include "error.h"
+#include "check.h"
+
+#include <stdlib.h>
+
+static void _link_before(ilist_t *list, ilist_link_t *position, ilist_link_t *link);
+static void _unlink(ilist_t *list, ilist_link_t *link);
+
+// -------------------------------------
+// Implementation of core functionality
+
+static void _link_before(ilist_t *list, ilist_link_t *position, ilist_link_t *link){
+    if(position == NULL){
+        link->next = NULL;
+        link->prev = list->last;
+
+        if(list->last != NULL)
+            list->last->next = link;
+        else
+            list->first = link;
+
+        list->last = link;
+    }
+    else{
+        link->next = position;
+        link->prev = position->prev;
+
+        if(position->prev != NULL)
+            position->prev->next = link;
+        else
+            list->first = link;
+
+        position->prev = link;
+    }
+
+    list->count++;
+}
+
+static void _unlink(ilist_t *list, ilist_link_t *link){
+    if(link->prev != NULL)
+        link->prev->next = link->next;
+    else
+        list->first = link->next;
+
+    if(link->next != NULL)
+        link->next->prev = link->prev;
+    else
+        list->last = link->prev;
+
+    link->next = NULL;
+    link->prev = NULL;
+
+    list->count--;
+}
+
+// -------------------------------------
+// Implementation of intrusive lists
+
+void ilist_init(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    list->first = NULL;
+    list->last = NULL;
+    list->count = 0;
+}
+
+void ilist_append(ilist_t *list, ilist_link_t *link){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(link);
+
+    _link_before(list, NULL, link);
+}
+
+void ilist_prepend(ilist_t *list, ilist_link_t *link){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(link);
+
+    _link_before(list, list->first, link);
+}
+
+void ilist_insert_before(ilist_t *list, ilist_link_t *position, ilist_link_t *link){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(link);
+
+    _link_before(list, position, link);
+}
+
+void ilist_remove(ilist_t *list, ilist_link_t *link){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(link);
+
+    if(list->count == 0){
+        error("Called ilist_remove for empty list!");
+    }
+
+    _unlink(list, link);
+}
+
+ilist_link_t *ilist_pop(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    if(list->count == 0){
+        error("Called pop at empty list!");
+    }
+
+    ilist_link_t *tmp = list->last;
+    _unlink(list, tmp);
+
+    return tmp;
+}
+
+ilist_link_t *ilist_windraw(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    if(list->count == 0){
+        error("Called windraw at empty list!");
+    }
+
+    ilist_link_t *tmp = list->first;
+    _unlink(list, tmp);
+
+    return tmp;
+}
+
+ilist_link_t *ilist_first(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    return list->first;
+}
+
+ilist_link_t *ilist_last(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    return list->last;
+}
+
+unsigned ilist_count(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    return list->count;
+}
+
+bool ilist_empty(ilist_t *list){
+    CHECK_NULL_ARGUMENT(list);
+
+    return (list->count == 0) ? true : false;
+}
@@ -0,0 +1,163 @@
+/**
+ * @defgroup ilist_group Intrusive lists
+ *
+ * @brief Double linked lists without any allocation.
+ *
+ * Unlike lists from list.h, intrusive list doesn't copy any data and doesn't
+ * allocate anything. User embed ilist_link_t into own structure and list only
+ * chain these links together. Structure holding the link can be obtained back
+ * by ILIST_ENTRY() macro. One structure can be in more lists at once if it
+ * have more links.
+ *
+ * Memory of linked structures is owned by user, list object itself can be
+ * placed anywhere (on stack, inside other structure) and is set up by
+ * ilist_init().
+ *
+ * @code{.c}
+ * typedef struct{
+ *     int value;
+ *     ilist_link_t link;
+ * }my_item_t;
+ *
+ * ilist_t list;
+ * my_item_t a = {.value = 1};
+ *
+ * ilist_init(&list);
+ * ilist_append(&list, &a.link);
+ *
+ * for(ilist_link_t *head = ilist_first(&list); head != NULL; head = head->next){
+ *     my_item_t *item = ILIST_ENTRY(head, my_item_t, link);
+ * }
+ * @endcode
+ *
+ * @ingroup core_group
+ *
+ * @{
+ */
+
+#ifndef ILIST_H_included
+#define ILIST_H_included
+
+#include <stddef.h>
+#include <stdbool.h>
+
+/**
+ * @brief Get pointer to structure containing given link.
+ *
+ * @param link Pointer to ilist_link_t.
+ * @param type Type of structure containing the link.
+ * @param member Name of link member inside of structure.
+ */
+#define ILIST_ENTRY(link, type, member) ((type *)((char *)(link) - offsetof(type, member)))
+
+/**
+ * @brief Link to be embedded into user structure.
+ */
+typedef struct ilist_link_s{
+    struct ilist_link_s *next;  /**< @brief Next link in list or NULL. */
+    struct ilist_link_s *prev;  /**< @brief Previous link in list or NULL. */
+}ilist_link_t;
+
+/**
+ * @brief Intrusive list object.
+ */
+typedef struct{
+    ilist_link_t *first;        /**< @brief First link in list. */
+    ilist_link_t *last;         /**< @brief Last link in list. */
+    unsigned count;             /**< @brief Count of links in list. */
+}ilist_t;
+
+/**
+ * @brief Set up empty list.
+ *
+ * @param list List object to be set.
+ */
+extern void ilist_init(ilist_t *list);
+
+/**
+ * @brief Put link at the end of list.
+ *
+ * @param list List object.
+ * @param link Link that isn't in any list.
+ */
+extern void ilist_append(ilist_t *list, ilist_link_t *link);
+
+/**
+ * @brief Put link at the beginning of list.
+ *
+ * @param list List object.
+ * @param link Link that isn't in any list.
+ */
+extern void ilist_prepend(ilist_t *list, ilist_link_t *link);
+
+/**
+ * @brief Put link in front of other link.
+ *
+ * @param list List object.
+ * @param position Link already in list. If NULL, link is appended.
+ * @param link Link that isn't in any list.
+ */
+extern void ilist_insert_before(ilist_t *list, ilist_link_t *position, ilist_link_t *link);
+
+/**
+ * @brief Remove link from list.
+ *
+ * @param list List object.
+ * @param link Link that is in given list.
+ */
+extern void ilist_remove(ilist_t *list, ilist_link_t *link);
+
+/**
+ * @brief Take out last link of list.
+ *
+ * @param list Non empty list object.
+ * @return Removed link.
+ */
+extern ilist_link_t *ilist_pop(ilist_t *list);
+
+/**
+ * @brief Take out first link of list.
+ *
+ * @param list Non empty list object.
+ * @return Removed link.
+ */
+extern ilist_link_t *ilist_windraw(ilist_t *list);
+
+/**
+ * @brief Get first link of list.
+ *
+ * @param list List object.
+ * @return First link or NULL if list is empty.
+ */
+extern ilist_link_t *ilist_first(ilist_t *list);
+
+/**
+ * @brief Get last link of list.
+ *
+ * @param list List object.
+ * @return Last link or NULL if list is empty.
+ */
+extern ilist_link_t *ilist_last(ilist_t *list);
+
+/**
+ * @brief Get count of links in list.
+ *
+ * @param list List object.
+ * @return Count of links.
+ */
+extern unsigned ilist_count(ilist_t *list);
+
+/**
+ * @brief Check if list is empty.
+ *
+ * @param list List object.
+ * @return true List is empty.
+ * @return false There is at least one link in list.
+ */
+extern bool ilist_empty(ilist_t *list);
+
+#endif
+
+/**
+ * @}
+ */
@@ -6,56 +6,156 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 
-static list_t *_new_list(size_t item_size);
-static list_item_t *_new_list_item(size_t data_size);
-static void _free_list_item(list_item_t *item);
+// Data of item are stored right after item header in the same allocation, so
+// header size is rounded up to keep data aligned for any type.
+typedef union{
+    long double ld;
+    intmax_t im;
+    void *ptr;
+    void (*fn)(void);
+}_list_align_t;
+
+#define LIST_ITEM_DATA_OFFSET \
+    (((sizeof(list_item_t) + sizeof(_list_align_t) - 1) / sizeof(_list_align_t)) * sizeof(_list_align_t))
+
+// Each slab of pool start with pointer to previously allocated slab.
+#define LIST_POOL_SLAB_HEADER_SIZE sizeof(_list_align_t)
+
+static list_t *_new_list(size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator);
+static list_item_t *_new_list_item(list_t *list);
+static void _free_list_item(list_t *list, list_item_t *item);
 static void _free_list(list_t *list);
+static list_item_t *_pool_take(list_t *list);
+static void _pool_give(list_t *list, list_item_t *item);
+static void _pool_release(list_t *list);
 static void _append_item(list_t *list, list_item_t *item, long position);
 static list_item_t *_takeout_item(list_t *list, long position);
+static void _unlink_item(list_t *list, list_item_t *item);
 static list_item_t *_at(list_t *list, long position);
 static void _destroy(list_t *list);
 
+static void *_chunk_slot(list_t *list, unsigned position);
+static void _chunk_push_back(list_t *list);
+static void _chunk_push_front(list_t *list);
+static void _chunk_pop_back(list_t *list);
+static void _chunk_pop_front(list_t *list);
+static void _chunk_insert(list_t *list, unsigned position, void *data);
+static void _chunk_remove(list_t *list, unsigned position);
+static void _chunk_destroy(list_t *list);
+
+static void *_data_at(list_t *list, long position);
+static void _insert(list_t *list, long position, void *data);
+static void _remove(list_t *list, long position);
+
 // -------------------------------------
 // Implementation of core functionality
 
-static list_t *_new_list(size_t item_size){
+static list_t *_new_list(size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator){
     list_t *tmp = NULL;
 
-    tmp = (list_t *)malloc(sizeof(list_t));
-    dynmem_check_malloc((void *)tmp);
+    tmp = (list_t *)dynmem_allocator_alloc(allocator, sizeof(list_t));
+
+    memset(tmp, 0, sizeof(list_t));
 
     tmp->count = 0;
     tmp->first = NULL;
     tmp->last = NULL;
     tmp->item_size = item_size;
+    tmp->backend = backend;
+    tmp->allocator = allocator;
 
     return tmp;
 }
 
-static list_item_t *_new_list_item(size_t data_size){
+static list_item_t *_new_list_item(list_t *list){
     list_item_t *tmp = NULL;
 
-    tmp = (list_item_t *)malloc(sizeof(list_item_t));
-    dynmem_check_malloc((void *)tmp);
+    if(list->pool.slab_items > 0){
+        tmp = _pool_take(list);
+    }
+    else{
+        tmp = (list_item_t *)dynmem_allocator_alloc(list->allocator, LIST_ITEM_DATA_OFFSET + list->item_size);
+    }
 
     tmp->next = NULL;
     tmp->prev = NULL;
-
-    tmp->data = malloc(data_size);
-    dynmem_check_malloc(tmp->data);
+    tmp->data = (void *)((char *)tmp + LIST_ITEM_DATA_OFFSET);
 
     return tmp;
 }
 
-static void _free_list_item(list_item_t *item){
-    free(item->data);
-    free(item);
+static void _free_list_item(list_t *list, list_item_t *item){
+    if(list->pool.slab_items > 0)
+        _pool_give(list, item);
+    else
+        dynmem_allocator_free(list->allocator, item, LIST_ITEM_DATA_OFFSET + list->item_size);
 }
 
 static void _free_list(list_t *list){
-    free(list);
+    dynmem_allocator_free(list->allocator, list, sizeof(list_t));
+}
+
+// -------------------------------------
+// Implementation of item pool
+
+static inline size_t _pool_item_size(list_t *list){
+    size_t size = LIST_ITEM_DATA_OFFSET + list->item_size;
+    return ((size + sizeof(_list_align_t) - 1) / sizeof(_list_align_t)) * sizeof(_list_align_t);
+}
+
+static inline size_t _pool_slab_size(list_t *list){
+    return LIST_POOL_SLAB_HEADER_SIZE + list->pool.slab_items * _pool_item_size(list);
+}
+
+static list_item_t *_pool_take(list_t *list){
+    list_item_t *tmp = NULL;
+
+    list->pool.stats.requests++;
+    list->pool.stats.in_use++;
+
+    if(list->pool.free != NULL){
+        tmp = list->pool.free;
+        list->pool.free = tmp->next;
+        list->pool.stats.recycled++;
+        return tmp;
+    }
+
+    if(list->pool.slabs == NULL || list->pool.slab_used == list->pool.slab_items){
+        void **slab = (void **)dynmem_allocator_alloc(list->allocator, _pool_slab_size(list));
+
+        *slab = list->pool.slabs;
+        list->pool.slabs = (void *)slab;
+        list->pool.slab_used = 0;
+        list->pool.stats.slabs++;
+    }
+
+    tmp = (list_item_t *)((char *)list->pool.slabs + LIST_POOL_SLAB_HEADER_SIZE + list->pool.slab_used * _pool_item_size(list));
+    list->pool.slab_used++;
+
+    return tmp;
+}
+
+static void _pool_give(list_t *list, list_item_t *item){
+    item->next = list->pool.free;
+    list->pool.free = item;
+    list->pool.stats.in_use--;
+}
+
+static void _pool_release(list_t *list){
+    void **slab = (void **)list->pool.slabs;
+
+    while(slab != NULL){
+        void **next = (void **)*slab;
+        dynmem_allocator_free(list->allocator, slab, _pool_slab_size(list));
+        slab = next;
+    }
+
+    list->pool.slabs = NULL;
+    list->pool.free = NULL;
+    list->pool.slab_used = 0;
 }
 
 static void _append_item(list_t *list, list_item_t *item, long position){
@@ -74,10 +174,7 @@ static void _append_item(list_t *list, list_item_t *item, long position){
             list->first = item;
         }
         else{
-            list_item_t *head = list->first;
-
-            for(long i = 1; i < position; i++)
-                head = head->next;
+            list_item_t *head = _at(list, position - 1);
 
             item->next = head->next;
             item->prev = head;
@@ -96,50 +193,31 @@ static void _append_item(list_t *list, list_item_t *item, long position){
 static list_item_t *_takeout_item(list_t *list, long position){
     list_item_t *tmp = NULL;
 
-    if((unsigned)position == list->count - 1)
-        position = -1;
-
-    if(position == -1){
+    if(position == -1)
         tmp = list->last;
+    else
+        tmp = _at(list, position);
 
-        if(list->first == list->last){
-            list->first = NULL;
-            list->last = NULL;
-        }
-        else{
-            list->last = list->last->prev;
-            list->last->next = NULL;
-        }
-    }
-    else if(position == 0){
-        tmp = list->first;
+    _unlink_item(list, tmp);
 
-        if(list->first == list->last){
-            list->first = NULL;
-            list->last = NULL;
-        }
-        else{
-            list->first = list->first->next;
-            list->first->prev = NULL;
-        }
-    }
-    else{
-        tmp = list->first->next;
+    return tmp;
+}
 
-        for(long i = 1; i != position; i++){
-            tmp = tmp->next;
-        }
+static void _unlink_item(list_t *list, list_item_t *item){
+    if(item->prev != NULL)
+        item->prev->next = item->next;
+    else
+        list->first = item->next;
 
-        tmp->prev->next = tmp->next;
-        tmp->next->prev = tmp->prev;
-    }
+    if(item->next != NULL)
+        item->next->prev = item->prev;
+    else
+        list->last = item->prev;
 
-    tmp->prev = NULL;
-    tmp->next = NULL;
+    item->prev = NULL;
+    item->next = NULL;
 
     list->count--;
-
-    return tmp;
 }
 
 static list_item_t *_at(list_t *list, long position){
@@ -154,32 +232,244 @@ static list_item_t *_at(list_t *list, long position){
     else if(position == 0){
         tmp = list->first;
     }
-    else{
-        list_item_t *head = list->first;
+    else if((unsigned)position < list->count / 2){
+        tmp = list->first;
 
         for(long i = 0; i != position; i++){
-            head = head->next;
+            tmp = tmp->next;
         }
+    }
+    else{
+        tmp = list->last;
 
-        tmp = head;
+        for(long i = list->count - 1; i != position; i--){
+            tmp = tmp->prev;
+        }
     }
 
     return tmp;
 }
 
 static void _destroy(list_t *list){
-    list_item_t *head = list->first;
-    list_item_t *tmp = NULL;
+    if(list->backend == LIST_BACKEND_CHUNKED){
+        _chunk_destroy(list);
+    }
+    else if(list->pool.slab_items > 0){
+        _pool_release(list);
+    }
+    else{
+        list_item_t *head = list->first;
+        list_item_t *tmp = NULL;
 
-    while(head != NULL){
-        tmp = head;
-        head = head->next;
-        _free_list_item(tmp);
+        while(head != NULL){
+            tmp = head;
+            head = head->next;
+            _free_list_item(list, tmp);
+        }
     }
 
     _free_list(list);
 }
 
+// -------------------------------------
+// Implementation of chunked storage
+
+static inline size_t _chunk_size(list_t *list){
+    return list->item_size * LIST_CHUNK_ITEMS;
+}
+
+static inline void **_chunk_ref(list_t *list, unsigned index){
+    return &(list->chunked.chunks[(list->chunked.head + index) & (list->chunked.capacity - 1)]);
+}
+
+static void *_chunk_slot(list_t *list, unsigned position){
+    unsigned slot = list->chunked.offset + position;
+    char *chunk = (char *)*_chunk_ref(list, slot / LIST_CHUNK_ITEMS);
+
+    return (void *)(chunk + (slot % LIST_CHUNK_ITEMS) * list->item_size);
+}
+
+static void *_chunk_new(list_t *list){
+    void *tmp = list->chunked.spare;
+
+    if(tmp != NULL){
+        list->chunked.spare = NULL;
+        return tmp;
+    }
+
+    tmp = dynmem_allocator_alloc(list->allocator, _chunk_size(list));
+
+    return tmp;
+}
+
+static void _chunk_release(list_t *list, void *chunk){
+    if(list->chunked.spare == NULL)
+        list->chunked.spare = chunk;
+    else
+        dynmem_allocator_free(list->allocator, chunk, _chunk_size(list));
+}
+
+static void _chunk_grow_directory(list_t *list){
+    unsigned new_capacity = (list->chunked.capacity == 0) ? 4 : list->chunked.capacity * 2;
+    void **tmp = (void **)dynmem_allocator_alloc(list->allocator, new_capacity * sizeof(void *));
+
+    for(unsigned i = 0; i < list->chunked.used; i++){
+        tmp[i] = *_chunk_ref(list, i);
+    }
+
+    dynmem_allocator_free(list->allocator, list->chunked.chunks, list->chunked.capacity * sizeof(void *));
+
+    list->chunked.chunks = tmp;
+    list->chunked.capacity = new_capacity;
+    list->chunked.head = 0;
+}
+
+static void _chunk_reset(list_t *list){
+    while(list->chunked.used > 0){
+        _chunk_release(list, *_chunk_ref(list, --list->chunked.used));
+    }
+
+    list->chunked.head = 0;
+    list->chunked.offset = 0;
+}
+
+static void _chunk_push_back(list_t *list){
+    unsigned slot = list->chunked.offset + list->count;
+
+    if(slot == list->chunked.used * LIST_CHUNK_ITEMS){
+        if(list->chunked.used == list->chunked.capacity)
+            _chunk_grow_directory(list);
+
+        *_chunk_ref(list, list->chunked.used) = _chunk_new(list);
+        list->chunked.used++;
+    }
+
+    list->count++;
+}
+
+static void _chunk_push_front(list_t *list){
+    if(list->chunked.offset == 0){
+        if(list->chunked.used == list->chunked.capacity)
+            _chunk_grow_directory(list);
+
+        list->chunked.head = (list->chunked.head - 1) & (list->chunked.capacity - 1);
+        *_chunk_ref(list, 0) = _chunk_new(list);
+        list->chunked.used++;
+        list->chunked.offset = LIST_CHUNK_ITEMS;
+    }
+
+    list->chunked.offset--;
+    list->count++;
+}
+
+static void _chunk_pop_back(list_t *list){
+    list->count--;
+
+    if(list->count == 0){
+        _chunk_reset(list);
+    }
+    else if(list->chunked.offset + list->count <= (list->chunked.used - 1) * LIST_CHUNK_ITEMS){
+        list->chunked.used--;
+        _chunk_release(list, *_chunk_ref(list, list->chunked.used));
+    }
+}
+
+static void _chunk_pop_front(list_t *list){
+    list->count--;
+    list->chunked.offset++;
+
+    if(list->count == 0){
+        _chunk_reset(list);
+    }
+    else if(list->chunked.offset == LIST_CHUNK_ITEMS){
+        _chunk_release(list, *_chunk_ref(list, 0));
+        list->chunked.head = (list->chunked.head + 1) & (list->chunked.capacity - 1);
+        list->chunked.used--;
+        list->chunked.offset = 0;
+    }
+}
+
+static void _chunk_insert(list_t *list, unsigned position, void *data){
+    size_t item_size = list->item_size;
+
+    //move shorter side of list to make space for new item
+    if(position >= list->count / 2){
+        _chunk_push_back(list);
+
+        for(unsigned i = list->count - 1; i > position; i--)
+            memcpy(_chunk_slot(list, i), _chunk_slot(list, i - 1), item_size);
+    }
+    else{
+        _chunk_push_front(list);
+
+        for(unsigned i = 0; i < position; i++)
+            memcpy(_chunk_slot(list, i), _chunk_slot(list, i + 1), item_size);
+    }
+
+    memcpy(_chunk_slot(list, position), data, item_size);
+}
+
+static void _chunk_remove(list_t *list, unsigned position){
+    size_t item_size = list->item_size;
+
+    if(position < list->count / 2){
+        for(unsigned i = position; i > 0; i--)
+            memcpy(_chunk_slot(list, i), _chunk_slot(list, i - 1), item_size);
+
+        _chunk_pop_front(list);
+    }
+    else{
+        for(unsigned i = position; i + 1 < list->count; i++)
+            memcpy(_chunk_slot(list, i), _chunk_slot(list, i + 1), item_size);
+
+        _chunk_pop_back(list);
+    }
+}
+
+static void _chunk_destroy(list_t *list){
+    _chunk_reset(list);
+
+    dynmem_allocator_free(list->allocator, list->chunked.spare, _chunk_size(list));
+    dynmem_allocator_free(list->allocator, list->chunked.chunks, list->chunked.capacity * sizeof(void *));
+}
+
+// -------------------------------------
+// Backend independent operations
+
+static void *_data_at(list_t *list, long position){
+    if(position == -1)
+        position = list->count - 1;
+
+    if(list->backend == LIST_BACKEND_CHUNKED)
+        return _chunk_slot(list, (unsigned)position);
+    else
+        return _at(list, position)->data;
+}
+
+static void _insert(list_t *list, long position, void *data){
+    if(position == -1)
+        position = list->count;
+
+    if(list->backend == LIST_BACKEND_CHUNKED){
+        _chunk_insert(list, (unsigned)position, data);
+    }
+    else{
+        list_item_t *item = _new_list_item(list);
+        memcpy(item->data, data, list->item_size);
+        _append_item(list, item, position);
+    }
+}
+
+static void _remove(list_t *list, long position){
+    if(position == -1)
+        position = list->count - 1;
+
+    if(list->backend == LIST_BACKEND_CHUNKED)
+        _chunk_remove(list, (unsigned)position);
+    else
+        _free_list_item(list, _takeout_item(list, position));
+}
+
 // -------------------------------------
 // Implementation of generic lists
 
@@ -187,25 +477,42 @@ void list_init(list_t **list, size_t item_size){
     CHECK_NULL_ARGUMENT(list);
     CHECK_NOT_NULL_ARGUMENT(*list);
 
-    *list = _new_list(item_size);
+    *list = _new_list(item_size, LIST_BACKEND_LINKED, dynmem_allocator_default());
+}
+
+void list_init_chunked(list_t **list, size_t item_size){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NOT_NULL_ARGUMENT(*list);
+
+    if(item_size == 0)
+        error("You can't create chunked list with items of size zero!");
+
+    *list = _new_list(item_size, LIST_BACKEND_CHUNKED, dynmem_allocator_default());
+}
+
+void list_init_allocator(list_t **list, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NOT_NULL_ARGUMENT(*list);
+    CHECK_NULL_ARGUMENT(allocator);
+
+    if(backend == LIST_BACKEND_CHUNKED && item_size == 0)
+        error("You can't create chunked list with items of size zero!");
+
+    *list = _new_list(item_size, backend, allocator);
 }
 
 void list_append(list_t *list, void *data){
     CHECK_NULL_ARGUMENT(list);
     CHECK_NULL_ARGUMENT(data);
 
-    list_item_t *item = _new_list_item(list->item_size);
-    memcpy(item->data, data, list->item_size);
-    _append_item(list, item, -1);
+    _insert(list, -1, data);
 }
 
 void list_push(list_t *list, void *data){
     CHECK_NULL_ARGUMENT(list);
     CHECK_NULL_ARGUMENT(data);
 
-    list_item_t *item = _new_list_item(list->item_size);
-    memcpy(item->data, data, list->item_size);
-    _append_item(list, item, -1);
+    _insert(list, -1, data);
 }
 
 void list_insert(list_t *list, unsigned position, void *data){
@@ -216,9 +523,7 @@ void list_insert(list_t *list, unsigned position, void *data){
         error("Position can't be larger than size of list!");
     }
 
-    list_item_t *item = _new_list_item(list->item_size);
-    memcpy(item->data, data, list->item_size);
-    _append_item(list, item, (long)position);
+    _insert(list, (long)position, data);
 }
 
 void list_pop(list_t *list, void *data){
@@ -229,13 +534,8 @@ void list_pop(list_t *list, void *data){
         error("Called pop at empty list!");
     }
 
-    list_item_t *tmp = NULL;
-
-    tmp = _at(list, -1);
-    memcpy(data, tmp->data, list->item_size);
-
-    tmp = _takeout_item(list, -1);
-    _free_list_item(tmp);
+    memcpy(data, _data_at(list, -1), list->item_size);
+    _remove(list, -1);
 }
 
 void list_windraw(list_t *list, void *data){
@@ -246,13 +546,8 @@ void list_windraw(list_t *list, void *data){
         error("Called windraw at empty list!");
     }
 
-    list_item_t *tmp = NULL;
-
-    tmp = _at(list, 0);
-    memcpy(data, tmp->data, list->item_size);
-
-    tmp = _takeout_item(list, 0);
-    _free_list_item(tmp);
+    memcpy(data, _data_at(list, 0), list->item_size);
+    _remove(list, 0);
 }
 
 unsigned list_count(list_t *list){
@@ -269,8 +564,7 @@ void list_at(list_t *list, unsigned position, void *data){
         error("Position can't be larger than size of list!");
     }
 
-    list_item_t *tmp = _at(list, (long)position);
-    memcpy(data, tmp->data, list->item_size);
+    memcpy(data, _data_at(list, (long)position), list->item_size);
 }
 
 void list_peek(list_t *list, void *data){
@@ -281,8 +575,7 @@ void list_peek(list_t *list, void *data){
         error("Called peek at empty list!");
     }
 
-    list_item_t *tmp = _at(list, -1);
-    memcpy(data, tmp->data, list->item_size);
+    memcpy(data, _data_at(list, -1), list->item_size);
 }
 
 void list_remove_at(list_t *list, unsigned position){
@@ -296,8 +589,7 @@ void list_remove_at(list_t *list, unsigned position){
         error("Position can't be larger than size of list!");
     }
 
-    list_item_t *tmp = _takeout_item(list, position);
-    _free_list_item(tmp);
+    _remove(list, (long)position);
 }
 
 void list_destroy(list_t *list){
@@ -310,17 +602,10 @@ void list_copy(list_t *list_in, list_t **list_out){
     CHECK_NULL_ARGUMENT(list_out);
     CHECK_NOT_NULL_ARGUMENT(*list_out);
 
+    list_t *tmp_list = _new_list(list_in->item_size, list_in->backend, list_in->allocator);
+    tmp_list->pool.slab_items = list_in->pool.slab_items;
 
-    size_t item_size = list_in->item_size;
-    list_t *tmp_list = _new_list(item_size);
-
-    for(unsigned i = 0; i < list_in->count; i++){
-        list_item_t *tmp_item = _new_list_item(item_size);
-        list_item_t *item_in = _at(list_in, i);
-
-        memcpy(tmp_item->data, item_in->data, item_size);
-        _append_item(tmp_list, tmp_item, -1);
-    }
+    list_merge(tmp_list, list_in);
 
     *list_out = tmp_list;
 }
@@ -333,17 +618,169 @@ void list_merge(list_t *list_A, list_t *list_B){
         error("Merging two differently sized lists!");
     }
 
-    size_t item_size = list_A->item_size;
+    //count is fixed first so merging list into itself is safe
+    unsigned count = list_B->count;
+    list_iter_t it;
 
-    for(unsigned i = 0; i < list_B->count; i++){
-        list_item_t *new_item = _new_list_item(item_size);
-        list_item_t *item_to_copy = _at(list_B, i);
+    list_iter_begin(list_B, &it);
 
-        memcpy(new_item->data, item_to_copy->data, item_size);
-        _append_item(list_A, new_item, -1);
+    for(unsigned i = 0; i < count; i++){
+        _insert(list_A, -1, list_iter_data(&it));
+        list_iter_next(&it);
     }
 }
 
+void list_config_pool(list_t *list, unsigned slab_items){
+    CHECK_NULL_ARGUMENT(list);
+
+    if(list->backend != LIST_BACKEND_LINKED){
+        error("Item pool can be used only with linked lists!");
+    }
+
+    if(list->count > 0 || list->pool.slabs != NULL){
+        error("Item pool have to be configured before list is used!");
+    }
+
+    list->pool.slab_items = slab_items;
+}
+
+void list_pool_stats(list_t *list, list_pool_stats_t *stats){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(stats);
+
+    *stats = list->pool.stats;
+}
+
+// -------------------------------------
+// Implementation of iterators
+
+void list_iter_begin(list_t *list, list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(iter);
+
+    iter->list = list;
+    iter->item = list->first;
+    iter->position = 0;
+}
+
+void list_iter_end(list_t *list, list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(list);
+    CHECK_NULL_ARGUMENT(iter);
+
+    iter->list = list;
+    iter->item = list->last;
+    iter->position = (list->count > 0) ? list->count - 1 : 0;
+}
+
+bool list_iter_valid(list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(iter);
+
+    return iter->position < iter->list->count;
+}
+
+void list_iter_next(list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(iter);
+
+    if(!list_iter_valid(iter))
+        error("Called list_iter_next on invalid iterator!");
+
+    if(iter->list->backend == LIST_BACKEND_LINKED)
+        iter->item = iter->item->next;
+
+    iter->position++;
+}
+
+void list_iter_prev(list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(iter);
+
+    if(!list_iter_valid(iter))
+        error("Called list_iter_prev on invalid iterator!");
+
+    if(iter->list->backend == LIST_BACKEND_LINKED)
+        iter->item = iter->item->prev;
+
+    if(iter->position == 0)
+        iter->position = iter->list->count;
+    else
+        iter->position--;
+}
+
+void *list_iter_data(list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(iter);
+
+    if(!list_iter_valid(iter))
+        error("Called list_iter_data on invalid iterator!");
+
+    if(iter->list->backend == LIST_BACKEND_CHUNKED)
+        return _chunk_slot(iter->list, iter->position);
+    else
+        return iter->item->data;
+}
+
+void list_iter_get(list_iter_t *iter, void *data){
+    CHECK_NULL_ARGUMENT(iter);
+    CHECK_NULL_ARGUMENT(data);
+
+    memcpy(data, list_iter_data(iter), iter->list->item_size);
+}
+
+void list_iter_erase(list_iter_t *iter){
+    CHECK_NULL_ARGUMENT(iter);
+
+    if(!list_iter_valid(iter))
+        error("Called list_iter_erase on invalid iterator!");
+
+    list_t *list = iter->list;
+
+    if(list->backend == LIST_BACKEND_CHUNKED){
+        _chunk_remove(list, iter->position);
+    }
+    else{
+        list_item_t *tmp = iter->item;
+
+        iter->item = tmp->next;
+        _unlink_item(list, tmp);
+        _free_list_item(list, tmp);
+    }
+}
+
+void list_iter_insert_before(list_iter_t *iter, void *data){
+    CHECK_NULL_ARGUMENT(iter);
+    CHECK_NULL_ARGUMENT(data);
+
+    list_t *list = iter->list;
+
+    if(!list_iter_valid(iter)){
+        _insert(list, -1, data);
+        iter->item = NULL;
+        iter->position = list->count;
+        return;
+    }
+
+    if(list->backend == LIST_BACKEND_CHUNKED){
+        _chunk_insert(list, iter->position, data);
+    }
+    else{
+        list_item_t *item = _new_list_item(list);
+        list_item_t *head = iter->item;
+
+        memcpy(item->data, data, list->item_size);
+
+        item->next = head;
+        item->prev = head->prev;
+
+        if(head->prev != NULL)
+            head->prev->next = item;
+        else
+            list->first = item;
+
+        head->prev = item;
+        list->count++;
+    }
+
+    iter->position++;
+}
+
 // -------------------------------------
 // implement stack using lists
 
@@ -351,6 +788,18 @@ void stack_init(stack_t **stack, size_t item_size){
     list_init((list_t **)stack, item_size);
 }
 
+void stack_init_chunked(stack_t **stack, size_t item_size){
+    list_init_chunked((list_t **)stack, item_size);
+}
+
+void stack_init_allocator(stack_t **stack, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator){
+    list_init_allocator((list_t **)stack, item_size, backend, allocator);
+}
+
+void stack_config_pool(stack_t *stack, unsigned slab_items){
+    list_config_pool((list_t *)stack, slab_items);
+}
+
 void stack_push(stack_t *stack, void *data){
     list_push((list_t *)stack, data);
 }
@@ -386,6 +835,18 @@ void queue_init(queue_t **queue, size_t item_size){
     list_init((list_t **)queue, item_size);
 }
 
+void queue_init_chunked(queue_t **queue, size_t item_size){
+    list_init_chunked((list_t **)queue, item_size);
+}
+
+void queue_init_allocator(queue_t **queue, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator){
+    list_init_allocator((list_t **)queue, item_size, backend, allocator);
+}
+
+void queue_config_pool(queue_t *queue, unsigned slab_items){
+    list_config_pool((list_t *)queue, slab_items);
+}
+
 void queue_append(queue_t *queue, void *data){
     list_append((list_t *)queue, data);
 }
@@ -419,19 +880,18 @@ static void print_struct(list_t *list, char *name, void (*print_data)(void *)){
         fprintf(stdout, "%s NULL\n", name);
     }
     else{
-        list_item_t *head = list->first;
+        list_iter_t it;
 
         fprintf(stdout, "%s (count: %u)\n", name, list->count);
 
-        while(head != NULL){
-            if(head->next == NULL)
+        for(list_iter_begin(list, &it); list_iter_valid(&it); list_iter_next(&it)){
+            if(it.position + 1 == list->count)
                 fprintf(stdout, " '- ");
             else
                 fprintf(stdout, " |- ");
 
-            (*print_data)(head->data);
+            (*print_data)(list_iter_data(&it));
             fprintf(stdout, "\n");
-            head = head->next;
         }
     }
     fflush(stdout);
@@ -6,11 +6,40 @@
  * Queues and stacks are also implemented using list like macro to
  * a bit simplify ussage.
  *
- * Given data are copyied into internally allocated stack memory. When returning
+ * Given data are copyied into internally allocated stack memory. For linked
+ * lists, data are stored in the same allocation as item itself. When returning
  * data is copied at specified locations and internally allocated memory is deallocated
  * again. This way user do not have to care about memory mannagent of list, simply
  * call list_init() at beginning and list_destroy() at the end.
  *
+ * Two storage backends are available. Lists created by list_init() are double
+ * linked lists, each item is allocated separately. Lists created by
+ * list_init_chunked() keep items next to each other in fixed size chunks, so
+ * list_at() is constant time and walking through list is cache friendly.
+ * Inserting into or removing from middle of chunked list have to move items
+ * around, both ends are cheap. All list, stack and queue functions work with
+ * both backends.
+ *
+ * Linked lists that are filled and emptied often can take their items from
+ * pool, see list_config_pool(). Released items are then kept for reuse
+ * instead of being returned to libc and whole pool is freed at once by
+ * list_destroy(). If you want to link your own structures without any copying
+ * or allocation see ilist.h.
+ *
+ * To walk through list use iterator instead of calling list_at() with
+ * increasing position, iterator keep its place in list so whole traversal is
+ * linear for both backends. Stacks and queues are lists too, so the same
+ * iterator can be used for them.
+ *
+ * @code{.c}
+ * list_iter_t it;
+ *
+ * for(list_iter_begin(list, &it); list_iter_valid(&it); list_iter_next(&it)){
+ *     int value = 0;
+ *     list_iter_get(&it, &value);
+ * }
+ * @endcode
+ *
  * @todo Add documentation.
  *
  * @ingroup core_group
@@ -22,12 +51,57 @@
 #define LIST_H_included
 
 #include <stddef.h>
+#include <stdbool.h>
+
+#include "dynmem.h"
+
+/**
+ * @brief Count of items stored in one chunk of chunked list.
+ */
+#ifndef LIST_CHUNK_ITEMS
+#define LIST_CHUNK_ITEMS 64
+#endif
+
+/**
+ * @brief Storage used by list object.
+ */
+typedef enum{
+    LIST_BACKEND_LINKED = 0,    /**< @brief Double linked list of separately allocated items. */
+    LIST_BACKEND_CHUNKED        /**< @brief Items stored continuously in chunks of LIST_CHUNK_ITEMS. */
+}list_backend_t;
+
+/**
+ * @brief Statistics of item pool, see list_config_pool().
+ */
+typedef struct{
+    unsigned long requests;     /**< @brief Count of items taken from pool. */
+    unsigned long recycled;     /**< @brief Requests served by previously released item. */
+    unsigned long slabs;        /**< @brief Count of slabs allocated. */
+    unsigned long in_use;       /**< @brief Items currently held by list. */
+}list_pool_stats_t;
 
 typedef struct{
     struct list_item_s *first;
     struct list_item_s *last;
     unsigned count;
     size_t item_size;
+    list_backend_t backend;
+    dynmem_allocator_t *allocator;  /**< @brief Allocator used for list and its items. */
+    struct{
+        void **chunks;          /**< @brief Circular directory of chunks. */
+        unsigned capacity;      /**< @brief Size of directory, always power of two. */
+        unsigned head;          /**< @brief Index of first used chunk in directory. */
+        unsigned used;          /**< @brief Count of chunks in use. */
+        unsigned offset;        /**< @brief Position of first item inside first chunk. */
+        void *spare;            /**< @brief One released chunk kept for reuse. */
+    }chunked;
+    struct{
+        void *slabs;            /**< @brief Singly linked allocated slabs, newest first. */
+        struct list_item_s *free;   /**< @brief Released items ready for reuse. */
+        unsigned slab_items;    /**< @brief Items per slab, zero when pool isn't used. */
+        unsigned slab_used;     /**< @brief Items already carved from newest slab. */
+        list_pool_stats_t stats;
+    }pool;
 }list_t;
 
 typedef struct list_item_s{
@@ -36,8 +110,31 @@ typedef struct list_item_s{
     void *data;
 }list_item_t;
 
+/**
+ * @brief Cursor pointing to one item of list.
+ *
+ * Iterator is invalid once it walk past either end of list, see
+ * list_iter_valid().
+ */
+typedef struct{
+    list_t *list;           /**< @brief List iterated over. */
+    list_item_t *item;      /**< @brief Current item, used by linked backend only. */
+    unsigned position;      /**< @brief Position of current item, equal to count when invalid. */
+}list_iter_t;
+
 // Generic list
 extern void list_init(list_t **list, size_t item_size);
+extern void list_init_chunked(list_t **list, size_t item_size);
+
+/**
+ * @brief Create list with given backend and allocator.
+ *
+ * @param list Pointer to pointer to NULL where new list will be stored.
+ * @param item_size Size of one item.
+ * @param backend Storage backend of list.
+ * @param allocator Allocator used for list object, items, chunks and pool.
+ */
+extern void list_init_allocator(list_t **list, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator);
 extern void list_append(list_t *list, void *data);
 extern void list_push(list_t *list, void *data);
 extern void list_insert(list_t *list, unsigned position, void *data);
@@ -52,9 +149,108 @@ extern void list_destroy(list_t *list);
 extern void list_copy(list_t *list_in, list_t **list_out);
 extern void list_merge(list_t *list_A, list_t *list_B); //put items from B after last of A
 
+/**
+ * @brief Let linked list take its items from pool.
+ *
+ * Items are allocated in slabs of given count and released items are reused.
+ * Pool is released at once in list_destroy().
+ *
+ * @param list Empty linked list.
+ * @param slab_items Count of items in one slab, zero disable pool.
+ */
+extern void list_config_pool(list_t *list, unsigned slab_items);
+
+/**
+ * @brief Get statistics of item pool.
+ *
+ * @param list List object.
+ * @param stats Where statistics will be copied to.
+ */
+extern void list_pool_stats(list_t *list, list_pool_stats_t *stats);
+
+// Iterators
+
+/**
+ * @brief Set iterator to first item of list.
+ *
+ * @param list List to iterate over, can be also stack or queue.
+ * @param iter Iterator to be set.
+ */
+extern void list_iter_begin(list_t *list, list_iter_t *iter);
+
+/**
+ * @brief Set iterator to last item of list.
+ *
+ * @param list List to iterate over, can be also stack or queue.
+ * @param iter Iterator to be set.
+ */
+extern void list_iter_end(list_t *list, list_iter_t *iter);
+
+/**
+ * @brief Check if iterator point to item.
+ *
+ * @param iter Iterator to check.
+ * @return true Iterator point to item of list.
+ * @return false Iterator walked out of list or list is empty.
+ */
+extern bool list_iter_valid(list_iter_t *iter);
+
+/**
+ * @brief Move iterator to next item.
+ *
+ * @param iter Valid iterator.
+ */
+extern void list_iter_next(list_iter_t *iter);
+
+/**
+ * @brief Move iterator to previous item.
+ *
+ * @param iter Valid iterator.
+ */
+extern void list_iter_prev(list_iter_t *iter);
+
+/**
+ * @brief Copy data of current item.
+ *
+ * @param iter Valid iterator.
+ * @param data Where data will be copied to.
+ */
+extern void list_iter_get(list_iter_t *iter, void *data);
+
+/**
+ * @brief Get pointer to data of current item stored inside list.
+ *
+ * @param iter Valid iterator.
+ * @return Pointer to data, valid until list is modified.
+ */
+extern void *list_iter_data(list_iter_t *iter);
+
+/**
+ * @brief Remove current item from list.
+ *
+ * Iterator is moved to item that followed removed one.
+ *
+ * @param iter Valid iterator.
+ */
+extern void list_iter_erase(list_iter_t *iter);
+
+/**
+ * @brief Insert new item in front of current one.
+ *
+ * Iterator keep pointing to the same item. If iterator is invalid new item is
+ * appended at the end of list.
+ *
+ * @param iter Iterator.
+ * @param data Data to be inserted.
+ */
+extern void list_iter_insert_before(list_iter_t *iter, void *data);
+
 // Use list to implement stack
 typedef list_t stack_t;
 extern void stack_init(stack_t **stack, size_t item_size);
+extern void stack_init_chunked(stack_t **stack, size_t item_size);
+extern void stack_init_allocator(stack_t **stack, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator);
+extern void stack_config_pool(stack_t *stack, unsigned slab_items);
 extern void stack_push(stack_t *stack, void *data);
 extern void stack_pop(stack_t *stack, void *data);
 extern unsigned stack_count(stack_t *stack);
@@ -67,6 +263,9 @@ extern void stack_merge(stack_t *stack_A, stack_t *stack_B);
 // Use list to implement queue
 typedef list_t queue_t;
 extern void queue_init(queue_t **queue, size_t item_size);
+extern void queue_init_chunked(queue_t **queue, size_t item_size);
+extern void queue_init_allocator(queue_t **queue, size_t item_size, list_backend_t backend, dynmem_allocator_t *allocator);
+extern void queue_config_pool(queue_t *queue, unsigned slab_items);
 extern void queue_append(queue_t *queue, void *data);
 extern void queue_windraw(queue_t *queue, void *data);
 extern unsigned queue_count(queue_t *queue);
@@ -1,22 +1,251 @@
 #include "string.h"
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <wchar.h>
 
-#include "array.h"
 #include "check.h"
 #include "error.h"
 #include "dynmem.h"
 
-#ifndef DEFAULT_STRING_SIZE
-#define DEFAULT_STRING_SIZE 64
-#endif
+#define STRING_FORMAT_SCRATCH_SIZE 256
+
+static string_t *_new_string(dynmem_allocator_t *allocator);
+static void _reserve(string_t *s, size_t capacity);
+static void _write(string_t *s, size_t position, const char *data, size_t length);
+static bool _format_aliases(string_t *s, const char *format, va_list args);
+static void _vwrite(string_t *s, size_t position, const char *format, va_list args);
+
+// -------------------------------------
+// Implementation of core functionality
+
+static string_t *_new_string(dynmem_allocator_t *allocator){
+    string_t *tmp = (string_t *)dynmem_allocator_alloc(allocator, sizeof(string_t));
+
+    tmp->data = tmp->local;
+    tmp->data[0] = '\0';
+    tmp->length = 0;
+    tmp->capacity = STRING_INLINE_SIZE;
+    tmp->allocator = allocator;
+
+    return tmp;
+}
+
+static void _reserve(string_t *s, size_t capacity){
+    if(capacity <= s->capacity)
+        return;
+
+    size_t new_capacity = s->capacity;
+
+    while(new_capacity < capacity)
+        new_capacity *= 2;
+
+    if(s->data == s->local){
+        s->data = (char *)dynmem_allocator_alloc(s->allocator, new_capacity);
+        memcpy(s->data, s->local, s->length + 1);
+    }
+    else{
+        s->data = (char *)dynmem_allocator_realloc(s->allocator, s->data, s->capacity, new_capacity);
+    }
+
+    s->capacity = new_capacity;
+}
+
+static void _write(string_t *s, size_t position, const char *data, size_t length){
+    //data can be part of string itself, e.g. concatenation with itself
+    if(data >= s->data && data < s->data + s->capacity){
+        size_t offset = (size_t)(data - s->data);
+        _reserve(s, position + length + 1);
+        data = s->data + offset;
+    }
+    else{
+        _reserve(s, position + length + 1);
+    }
+
+    memmove(s->data + position, data, length);
+    s->length = position + length;
+    s->data[s->length] = '\0';
+}
+
+static bool _format_aliases(string_t *s, const char *format, va_list args){
+    //only strings are read from arguments, %n and positional arguments are taken as alias below
+    if(strpbrk(format, "sSn$") == NULL)
+        return false;
+
+    const char *begin = s->data;
+    const char *end = s->data + s->capacity;
+    bool aliases = false;
+
+    va_list ap;
+    va_copy(ap, args);
+
+    //arguments are walked as vsnprintf would do it, anything unknown is taken as alias
+    for(const char *p = strchr(format, '%'); p != NULL && !aliases; p = strchr(p, '%')){
+        p++;
+
+        if(*p == '%'){
+            p++;
+            continue;
+        }
+
+        while(*p != '\0' && strchr("-+ #0", *p) != NULL)
+            p++;
+
+        if(*p == '*'){
+            (void)va_arg(ap, int);
+            p++;
+        }
+
+        while(*p >= '0' && *p <= '9')
+            p++;
+
+        if(*p == '.'){
+            p++;
+
+            if(*p == '*'){
+                (void)va_arg(ap, int);
+                p++;
+            }
+
+            while(*p >= '0' && *p <= '9')
+                p++;
+        }
+
+        //length modifier, hh and ll are stored as H and q
+        char size = '\0';
+
+        if(p[0] == 'h' && p[1] == 'h'){
+            size = 'H';
+            p += 2;
+        }
+        else if(p[0] == 'l' && p[1] == 'l'){
+            size = 'q';
+            p += 2;
+        }
+        else if(*p != '\0' && strchr("hljztL", *p) != NULL){
+            size = *p;
+            p++;
+        }
+
+        switch(*p){
+            case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+                switch(size){
+                    case 'l': (void)va_arg(ap, long); break;
+                    case 'q': (void)va_arg(ap, long long); break;
+                    case 'j': (void)va_arg(ap, intmax_t); break;
+                    case 'z': (void)va_arg(ap, size_t); break;
+                    case 't': (void)va_arg(ap, ptrdiff_t); break;
+                    default: (void)va_arg(ap, int); break;
+                }
+                break;
+            case 'c':
+                if(size == 'l')
+                    (void)va_arg(ap, wint_t);
+                else
+                    (void)va_arg(ap, int);
+                break;
+            case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+                if(size == 'L')
+                    (void)va_arg(ap, long double);
+                else
+                    (void)va_arg(ap, double);
+                break;
+            case 's':
+                if(size == 'l'){
+                    const wchar_t *arg = va_arg(ap, const wchar_t *);
+                    aliases = ((const char *)arg >= begin && (const char *)arg < end);
+                }
+                else{
+                    const char *arg = va_arg(ap, const char *);
+                    aliases = (arg >= begin && arg < end);
+                }
+                break;
+            case 'p':
+                (void)va_arg(ap, void *);
+                break;
+            default:
+                aliases = true;
+                break;
+        }
+
+        if(*p != '\0')
+            p++;
+    }
+
+    va_end(ap);
+
+    return aliases;
+}
+
+static void _vwrite(string_t *s, size_t position, const char *format, va_list args){
+    if(!_format_aliases(s, format, args)){
+        //formatted straight into tail, second pass only when it is too short
+        va_list args_1;
+        va_copy(args_1, args);
+        int length = vsnprintf(s->data + position, s->capacity - position, format, args_1);
+        va_end(args_1);
+
+        if(length < 0)
+            error("Formatting of string failed!");
+
+        if((size_t)length >= s->capacity - position){
+            _reserve(s, position + (size_t)length + 1);
+
+            va_list args_2;
+            va_copy(args_2, args);
+            vsnprintf(s->data + position, (size_t)length + 1, format, args_2);
+            va_end(args_2);
+        }
+
+        s->length = position + (size_t)length;
+        return;
+    }
+
+    //argument points into string, it would be overwritten while it is read
+    char scratch[STRING_FORMAT_SCRATCH_SIZE];
+
+    va_list args_1;
+    va_copy(args_1, args);
+    int length = vsnprintf(scratch, sizeof(scratch), format, args_1);
+    va_end(args_1);
+
+    if(length < 0)
+        error("Formatting of string failed!");
+
+    if((size_t)length < sizeof(scratch)){
+        _write(s, position, scratch, (size_t)length);
+        return;
+    }
+
+    //long output, only then there is temporary buffer
+    char *tmp = (char *)dynmem_allocator_alloc(s->allocator, (size_t)length + 1);
+
+    va_list args_2;
+    va_copy(args_2, args);
+    vsnprintf(tmp, (size_t)length + 1, format, args_2);
+    va_end(args_2);
+
+    _write(s, position, tmp, (size_t)length);
+    dynmem_allocator_free(s->allocator, tmp, (size_t)length + 1);
+}
+
+// -------------------------------------
+// Implementation of strings
 
 void string_init(string_t **s){
-    array_init(s, sizeof(char), DEFAULT_STRING_SIZE);
-    array_cleanup(*s);
+    string_init_allocator(s, dynmem_allocator_default());
+}
+
+void string_init_allocator(string_t **s, dynmem_allocator_t *allocator){
+    CHECK_NULL_ARGUMENT(s);
+    CHECK_NOT_NULL_ARGUMENT(*s);
+    CHECK_NULL_ARGUMENT(allocator);
+
+    *s = _new_string(allocator);
 }
 
 void string_init_1(string_t **s, char *data){
@@ -26,25 +255,33 @@ void string_init_1(string_t **s, char *data){
 }
 
 void string_destroy(string_t *s){
-    array_destroy(s);
+    CHECK_NULL_ARGUMENT(s);
+
+    if(s->data != s->local)
+        dynmem_allocator_free(s->allocator, s->data, s->capacity);
+
+    dynmem_allocator_free(s->allocator, s, sizeof(string_t));
 }
 
 char *string_get(string_t *s){
-    return array_get_data(s);
+    CHECK_NULL_ARGUMENT(s);
+    return s->data;
 }
 
 char string_at(string_t *s, unsigned pos){
     CHECK_NULL_ARGUMENT(s);
-    return *(char *)(array_at(s, pos));
+
+    if(pos > s->length)
+        error("Index out of string!");
+
+    return s->data[pos];
 }
 
 string_t *string_duplicate(string_t *s){
-    string_t *tmp = NULL;
-    array_init(&tmp, sizeof(char), array_get_size(s));
+    CHECK_NULL_ARGUMENT(s);
 
-    for(unsigned i = 0; i < array_get_size(s); i++){
-        array_set(tmp, i, array_at(s, i));
-    }
+    string_t *tmp = _new_string(s->allocator);
+    _write(tmp, 0, s->data, s->length);
 
     return tmp;
 }
@@ -60,56 +297,31 @@ int string_compare(string_t *s1, string_t *s2){
     CHECK_NULL_ARGUMENT(s1);
     CHECK_NULL_ARGUMENT(s2);
 
-    return strcmp((char *)array_get_data(s1), (char *)array_get_data(s2));
+    return strcmp(s1->data, s2->data);
 }
 
 unsigned string_length(string_t *s){
     CHECK_NULL_ARGUMENT(s);
 
-    return (unsigned)strlen((char *)array_get_data(s));
+    return (unsigned)s->length;
 }
 
 void string_concatenate(string_t *s1, string_t *s2){
     CHECK_NULL_ARGUMENT(s1);
     CHECK_NULL_ARGUMENT(s2);
 
-    char *s1_data = array_get_data(s1);
-    char *s2_data = array_get_data(s2);
-
-    size_t size_needed = strlen(s1_data) + strlen(s2_data) + 1;
-
-    while(size_needed > (size_t)array_get_size(s1)){
-        array_enlarge(s1);
-    }
-
-    s1_data = array_get_data(s1);
-    s2_data = array_get_data(s2);
-
-    char *ret = strcat(s1_data, s2_data);
-
-    if(ret != s1_data){
-        error("Something went horribly wrong in library strcat!");
-    }
+    _write(s1, s1->length, s2->data, s2->length);
 }
 
 void string_puts(string_t *s, char *data){
     CHECK_NULL_ARGUMENT(s);
     CHECK_NULL_ARGUMENT(data);
 
-    if(strlen(data) == 0){
+    if(data[0] == '\0'){
         return;
     }
 
-    size_t size_needed = strlen(data) + 1;
-
-    while(size_needed > (size_t)array_get_size(s)){
-        array_enlarge(s);
-    }
-
-    array_cleanup(s);
-
-    char *tmp = array_get_data(s);
-    sprintf(tmp, "%s", data);
+    _write(s, 0, data, strlen(data));
 }
 
 void string_printf(string_t *s, char *format, ...){
@@ -134,32 +346,14 @@ void string_vprintf(string_t *s, char *format, va_list args){
         return;
     }
 
-    va_list args_1;
-    va_list args_2;
-
-    va_copy(args_1, args);
-    va_copy(args_2, args);
-
-    int length = vsnprintf(NULL, 0, format, args_1);
-    char *tmp = dynmem_calloc(length + 1, sizeof(char));
-    vsprintf(tmp, format, args_2);
-    string_puts(s, tmp);
-
-    dynmem_free(tmp);
-
-    va_end(args_1);
-    va_end(args_2);
+    _vwrite(s, 0, format, args);
 }
 
 void string_append(string_t *s, char *data){
     CHECK_NULL_ARGUMENT(s);
     CHECK_NULL_ARGUMENT(data);
 
-    string_t *tmp = NULL;
-
-    string_init_1(&tmp, data);
-    string_concatenate(s, tmp);
-    string_destroy(tmp);
+    _write(s, s->length, data, strlen(data));
 }
 
 void string_appendf(string_t *s, char *format, ...){
@@ -184,10 +378,5 @@ void string_vappendf(string_t *s, char *format, va_list args){
         return;
     }
 
-    string_t *tmp = NULL;
-
-    string_init(&tmp);
-    string_vprintf(tmp, format, args);
-    string_concatenate(s, tmp);
-    string_destroy(tmp);
+    _vwrite(s, s->length, format, args);
 }
@@ -4,11 +4,33 @@
 #include <stdbool.h>
 #include <stdarg.h>
 
-#include "array.h"
-
-typedef array_t string_t;
+#include <stddef.h>
+
+#include "dynmem.h"
+
+/**
+ * @brief Size of buffer stored inside of string object.
+ *
+ * Shorter strings (terminator included) don't need any other allocation.
+ *
+ * @note Value is part of layout of string_t, so library and its users must
+ * agree on it. It is fixed and can't be configured.
+ */
+#define STRING_INLINE_SIZE 32
+
+/**
+ * @brief String object, data are always terminated by zero.
+ */
+typedef struct{
+    char *data;                     /**< @brief Zero terminated content, points to local or to heap. */
+    size_t length;                  /**< @brief Length of content without terminator. */
+    size_t capacity;                /**< @brief Size of data in bytes, terminator included. */
+    dynmem_allocator_t *allocator;  /**< @brief Allocator used for string and its data. */
+    char local[STRING_INLINE_SIZE]; /**< @brief Inline storage for short strings. */
+}string_t;
 
 extern void string_init(string_t **s);
+extern void string_init_allocator(string_t **s, dynmem_allocator_t *allocator);
 extern void string_init_1(string_t **s, char *data);
 extern void string_destroy(string_t *s);
 
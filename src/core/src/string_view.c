@@ -0,0 +1,137 @@
+#include "string_view.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "check.h"
+#include "error.h"
+#include "dynmem.h"
+
+#define FNV_OFFSET_BASIS 2166136261u
+#define FNV_PRIME 16777619u
+
+static size_t _strnlen(const char *s, size_t max_length);
+
+// -------------------------------------
+// Implementation of core functionality
+
+//strnlen() is POSIX, not C99
+static size_t _strnlen(const char *s, size_t max_length){
+    size_t length = 0;
+
+    while(length < max_length && s[length] != '\0'){
+        length++;
+    }
+
+    return length;
+}
+
+// -------------------------------------
+// Implementation of string views
+
+string_view_t string_view_make(const char *data, size_t length){
+    if(data == NULL && length != 0)
+        error("View of NULL can't have non zero length!");
+
+    string_view_t tmp = {.data = data, .length = length};
+    return tmp;
+}
+
+string_view_t string_view_from(const char *s){
+    CHECK_NULL_ARGUMENT(s);
+
+    return string_view_make(s, strlen(s));
+}
+
+string_view_t string_view_of_string(string_t *s){
+    CHECK_NULL_ARGUMENT(s);
+
+    return string_view_make(s->data, s->length);
+}
+
+string_view_t string_view_substr(string_view_t view, size_t start, size_t length){
+    if(start > view.length)
+        error("Start of substring is out of view!");
+
+    if(length > view.length - start)
+        length = view.length - start;
+
+    return string_view_make(view.data + start, length);
+}
+
+bool string_view_equal(string_view_t a, string_view_t b){
+    if(a.length != b.length)
+        return false;
+
+    if(a.length == 0)
+        return true;
+
+    return (memcmp(a.data, b.data, a.length) == 0) ? true : false;
+}
+
+bool string_view_equal_cstr(string_view_t view, const char *s){
+    CHECK_NULL_ARGUMENT(s);
+
+    //length of s is checked first, so s is never read past its end even
+    //when view contains zero character
+    if(_strnlen(s, view.length + 1) != view.length)
+        return false;
+
+    return (view.length == 0 || memcmp(s, view.data, view.length) == 0) ? true : false;
+}
+
+int string_view_compare(string_view_t a, string_view_t b){
+    size_t length = (a.length < b.length) ? a.length : b.length;
+    int ret = (length != 0) ? memcmp(a.data, b.data, length) : 0;
+
+    if(ret != 0)
+        return ret;
+
+    if(a.length == b.length)
+        return 0;
+
+    return (a.length < b.length) ? -1 : 1;
+}
+
+bool string_view_starts_with(string_view_t view, string_view_t prefix){
+    if(prefix.length > view.length)
+        return false;
+
+    return string_view_equal(string_view_make(view.data, prefix.length), prefix);
+}
+
+uint32_t string_view_hash(string_view_t view){
+    uint32_t hash = FNV_OFFSET_BASIS;
+
+    for(size_t i = 0; i < view.length; i++){
+        hash ^= (uint8_t)view.data[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+char *string_view_strdup(string_view_t view){
+    char *tmp = (char *)dynmem_malloc(view.length + 1);
+
+    if(view.length != 0)
+        memcpy(tmp, view.data, view.length);
+
+    tmp[view.length] = '\0';
+
+    return tmp;
+}
+
+char *string_view_arena_strdup(dynmem_arena_t *arena, string_view_t view){
+    CHECK_NULL_ARGUMENT(arena);
+
+    char *tmp = (char *)dynmem_arena_malloc(arena, view.length + 1);
+
+    if(view.length != 0)
+        memcpy(tmp, view.data, view.length);
+
+    tmp[view.length] = '\0';
+
+    return tmp;
+}
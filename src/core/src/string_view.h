@@ -0,0 +1,151 @@
+/**
+ * @defgroup string_view_group String views
+ *
+ * @brief Reference to part of string without copying it.
+ *
+ * View is just pointer and length, it doesn't own referenced memory and
+ * doesn't have to be terminated by zero. This make it possible to work with
+ * parts of bigger buffer (e.g. tokens in input) without making copy of each
+ * part. Referenced memory have to outlive the view.
+ *
+ * Views are small, so they are passed and returned by value.
+ *
+ * @code{.c}
+ * char *input = "log2 ( 16 )";
+ * string_view_t name = string_view_make(input, 4);
+ *
+ * if(string_view_equal_cstr(name, "log2")){
+ *     char *copy = string_view_strdup(name);   //zero terminated copy
+ *     dynmem_free(copy);
+ * }
+ * @endcode
+ *
+ * @ingroup core_group
+ *
+ * @{
+ */
+
+#ifndef STRING_VIEW_H_included
+#define STRING_VIEW_H_included
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "dynmem.h"
+#include "string.h"
+
+/**
+ * @brief View object.
+ */
+typedef struct{
+    const char *data;   /**< @brief First referenced char. */
+    size_t length;      /**< @brief Count of referenced chars. */
+}string_view_t;
+
+/**
+ * @brief Create view of given memory.
+ *
+ * @param data Pointer to first char, can be NULL only if length is zero.
+ * @param length Count of chars.
+ * @return New view.
+ */
+extern string_view_t string_view_make(const char *data, size_t length);
+
+/**
+ * @brief Create view of zero terminated string.
+ *
+ * @param s Zero terminated string.
+ * @return View of whole string without terminator.
+ */
+extern string_view_t string_view_from(const char *s);
+
+/**
+ * @brief Create view of string object.
+ *
+ * @note View is valid only until string is modified.
+ *
+ * @param s String object.
+ * @return View of whole string.
+ */
+extern string_view_t string_view_of_string(string_t *s);
+
+/**
+ * @brief Get part of view.
+ *
+ * @param view Source view.
+ * @param start Position of first char, have to be within view.
+ * @param length Count of chars, it is shortened if it reach past view.
+ * @return View of part of source view.
+ */
+extern string_view_t string_view_substr(string_view_t view, size_t start, size_t length);
+
+/**
+ * @brief Check if two views have same content.
+ *
+ * @param a First view.
+ * @param b Second view.
+ * @return true Content is same.
+ * @return false Content differ.
+ */
+extern bool string_view_equal(string_view_t a, string_view_t b);
+
+/**
+ * @brief Check if view has same content as zero terminated string.
+ *
+ * @param view View to check.
+ * @param s Zero terminated string.
+ * @return true Content is same.
+ * @return false Content differ.
+ */
+extern bool string_view_equal_cstr(string_view_t view, const char *s);
+
+/**
+ * @brief Compare two views like strcmp().
+ *
+ * @param a First view.
+ * @param b Second view.
+ * @return int Negative, zero or positive number like strcmp().
+ */
+extern int string_view_compare(string_view_t a, string_view_t b);
+
+/**
+ * @brief Check if view start with given prefix.
+ *
+ * @param view View to check.
+ * @param prefix Prefix to look for.
+ * @return true View starts with prefix.
+ * @return false View doesn't start with prefix.
+ */
+extern bool string_view_starts_with(string_view_t view, string_view_t prefix);
+
+/**
+ * @brief Compute hash of view content (FNV-1a).
+ *
+ * @param view View to hash.
+ * @return Hash, same content give same hash.
+ */
+extern uint32_t string_view_hash(string_view_t view);
+
+/**
+ * @brief Create zero terminated copy of view.
+ *
+ * @param view View to copy.
+ * @return New string, use dynmem_free() to release it.
+ */
+extern char *string_view_strdup(string_view_t view);
+
+/**
+ * @brief Create zero terminated copy of view in arena.
+ *
+ * @param arena Arena to allocate from.
+ * @param view View to copy.
+ * @return New string released together with arena.
+ */
+extern char *string_view_arena_strdup(dynmem_arena_t *arena, string_view_t view);
+
+#endif
+
+/**
+ * @}
+ */
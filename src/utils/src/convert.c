@@ -9,92 +9,110 @@
 #include <stdio.h>
 #include <limits.h>
 
+#define VIEW_CONVERSION_BUFFER_SIZE 80
+
 bool is_number(char *s){
-    return is_hex_number(s) || is_dec_number(s) || is_oct_number(s) || is_bin_number(s);
+    CHECK_NULL_ARGUMENT(s);
+    return is_number_view(string_view_from(s));
 }
 
 bool is_number_1(string_t *s){
     CHECK_NULL_ARGUMENT(s);
-    return is_number(string_get(s));
+    return is_number_view(string_view_of_string(s));
+}
+
+bool is_number_view(string_view_t s){
+    return is_hex_number_view(s) || is_dec_number_view(s) || is_oct_number_view(s) || is_bin_number_view(s);
 }
 
 bool is_hex_number(char *s){
     CHECK_NULL_ARGUMENT(s);
+    return is_hex_number_view(string_view_from(s));
+}
 
-    if(strncmp(s, "0x", 2) != 0)
+bool is_hex_number_1(string_t *s){
+    CHECK_NULL_ARGUMENT(s);
+    return is_hex_number_view(string_view_of_string(s));
+}
+
+bool is_hex_number_view(string_view_t s){
+    if(s.length < 2 || s.data[0] != '0' || s.data[1] != 'x')
         return false;
 
-    for(unsigned i = 2; s[i] != '\0'; i++){
-        char x = s[i];
+    for(size_t i = 2; i < s.length; i++){
+        unsigned char x = (unsigned char)s.data[i];
         if(isxdigit(x) == 0) return false;
     }
 
     return true;
 }
 
-bool is_hex_number_1(string_t *s){
+bool is_dec_number(char *s){
     CHECK_NULL_ARGUMENT(s);
-    return is_hex_number(string_get(s));
+    return is_dec_number_view(string_view_from(s));
 }
 
-bool is_dec_number(char *s){
+bool is_dec_number_1(string_t *s){
     CHECK_NULL_ARGUMENT(s);
+    return is_dec_number_view(string_view_of_string(s));
+}
 
-    if(s[0] == '0')
+bool is_dec_number_view(string_view_t s){
+    if(s.length > 0 && s.data[0] == '0')
         return false;
 
-    for(unsigned i = 0; s[i] != '\0'; i++){
-        char x = s[i];
-        char xp1 = s[i + 1];
-        if(x == '-' && i == 0 && xp1 != '\0') continue;
+    for(size_t i = 0; i < s.length; i++){
+        unsigned char x = (unsigned char)s.data[i];
+        if(x == '-' && i == 0 && s.length > 1) continue;
         if(isdigit(x) == 0) return false;
     }
 
     return true;
 }
 
-bool is_dec_number_1(string_t *s){
+bool is_oct_number(char *s){
     CHECK_NULL_ARGUMENT(s);
-    return is_dec_number(string_get(s));
+    return is_oct_number_view(string_view_from(s));
 }
 
-bool is_oct_number(char *s){
+bool is_oct_number_1(string_t *s){
     CHECK_NULL_ARGUMENT(s);
+    return is_oct_number_view(string_view_of_string(s));
+}
 
-    if(s[0] != '0')
+bool is_oct_number_view(string_view_t s){
+    if(s.length == 0 || s.data[0] != '0')
         return false;
 
-    for(unsigned i = 1; s[i] != '\0'; i++){
-        char x = s[i];
+    for(size_t i = 1; i < s.length; i++){
+        unsigned char x = (unsigned char)s.data[i];
         if(isdigit(x) == 0 || x == '8' || x == '9' ) return false;
     }
 
     return true;
 }
 
-bool is_oct_number_1(string_t *s){
+bool is_bin_number(char *s){
     CHECK_NULL_ARGUMENT(s);
-    return is_oct_number(string_get(s));
+    return is_bin_number_view(string_view_from(s));
 }
 
-bool is_bin_number(char *s){
+bool is_bin_number_1(string_t *s){
     CHECK_NULL_ARGUMENT(s);
+    return is_bin_number_view(string_view_of_string(s));
+}
 
-    if(strncmp(s, "0b", 2) != 0)
+bool is_bin_number_view(string_view_t s){
+    if(s.length < 2 || s.data[0] != '0' || s.data[1] != 'b')
         return false;
 
-    for(int i = 2; s[i] != '\0'; i++){
-        if(s[i] != '1' && s[i] != '0') return false;
+    for(size_t i = 2; i < s.length; i++){
+        if(s.data[i] != '1' && s.data[i] != '0') return false;
     }
 
     return true;
 }
 
-bool is_bin_number_1(string_t *s){
-    CHECK_NULL_ARGUMENT(s);
-    return is_bin_number(string_get(s));
-}
-
 bool str_to_num_signed(char *s, intmax_t *x){
     CHECK_NULL_ARGUMENT(s);
     CHECK_NULL_ARGUMENT(x);
@@ -179,6 +197,51 @@ bool str_to_num_unsigned_string(string_t *s, uintmax_t *x){
     return str_to_num_unsigned(string_get(s), x);
 }
 
+bool str_to_num_signed_view(string_view_t s, intmax_t *x){
+    CHECK_NULL_ARGUMENT(x);
+
+    if(is_number_view(s) == false)
+        return false;
+
+    //library conversion needs terminated string, valid numbers are short
+    char buffer[VIEW_CONVERSION_BUFFER_SIZE];
+    char *tmp = (s.length < sizeof(buffer)) ? buffer : (char *)dynmem_malloc(s.length + 1);
+
+    if(s.length != 0)
+        memcpy(tmp, s.data, s.length);
+
+    tmp[s.length] = '\0';
+
+    bool ret = str_to_num_signed(tmp, x);
+
+    if(tmp != buffer)
+        dynmem_free(tmp);
+
+    return ret;
+}
+
+bool str_to_num_unsigned_view(string_view_t s, uintmax_t *x){
+    CHECK_NULL_ARGUMENT(x);
+
+    if(is_number_view(s) == false)
+        return false;
+
+    char buffer[VIEW_CONVERSION_BUFFER_SIZE];
+    char *tmp = (s.length < sizeof(buffer)) ? buffer : (char *)dynmem_malloc(s.length + 1);
+
+    if(s.length != 0)
+        memcpy(tmp, s.data, s.length);
+
+    tmp[s.length] = '\0';
+
+    bool ret = str_to_num_unsigned(tmp, x);
+
+    if(tmp != buffer)
+        dynmem_free(tmp);
+
+    return ret;
+}
+
 bool can_fit_in_size_unsigned(uintmax_t x, size_t size){
     return can_fit_in_bits_unsigned(x, size * CHAR_BIT);
 }
@@ -36,6 +36,10 @@
  * return true;
  * @endcode
  *
+ * Every function have variant taking string_t object (suffix _1 or _string)
+ * and variant taking string_view_t (suffix _view), so parts of bigger buffer
+ * can be checked and converted without copying them first.
+ *
  * @note HEX format have to start with 0x prefix, OCT format have to
  * start with leading zero, DEC format is only one allowed to have sign
  * before number itself but can't have leading zeros, finally BIN format,
@@ -66,6 +70,7 @@
  */
 extern bool is_number(char *s);
 extern bool is_number_1(string_t *s);
+extern bool is_number_view(string_view_t s);
 
 /**
  * @brief Heck if string is HEX coded number.
@@ -76,6 +81,7 @@ extern bool is_number_1(string_t *s);
  */
 extern bool is_hex_number(char *s);
 extern bool is_hex_number_1(string_t *s);
+extern bool is_hex_number_view(string_view_t s);
 
 /**
  * @brief Heck if string is DEC coded number.
@@ -86,6 +92,7 @@ extern bool is_hex_number_1(string_t *s);
  */
 extern bool is_dec_number(char *s);
 extern bool is_dec_number_1(string_t *s);
+extern bool is_dec_number_view(string_view_t s);
 
 /**
  * @brief Heck if string is OCT coded number.
@@ -96,6 +103,7 @@ extern bool is_dec_number_1(string_t *s);
  */
 extern bool is_oct_number(char *s);
 extern bool is_oct_number_1(string_t *s);
+extern bool is_oct_number_view(string_view_t s);
 
 /**
  * @brief Heck if string is BIN coded number.
@@ -106,6 +114,7 @@ extern bool is_oct_number_1(string_t *s);
  */
 extern bool is_bin_number(char *s);
 extern bool is_bin_number_1(string_t *s);
+extern bool is_bin_number_view(string_view_t s);
 
 /**
  * @brief Convert given string to number.
@@ -119,6 +128,8 @@ extern bool str_to_num_signed(char *s, intmax_t *x);
 extern bool str_to_num_signed_string(string_t *s, intmax_t *x);
 extern bool str_to_num_unsigned(char *s, uintmax_t *x);
 extern bool str_to_num_unsigned_string(string_t *s, uintmax_t *x);
+extern bool str_to_num_signed_view(string_view_t s, intmax_t *x);
+extern bool str_to_num_unsigned_view(string_view_t s, uintmax_t *x);
 
 /**
  * @brief Check if given number can be fitted in specified type.
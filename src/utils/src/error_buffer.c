@@ -6,6 +6,10 @@ void error_buffer_init(error_buffer_t **error_buffer){
     string_init((string_t **)error_buffer);
 }
 
+void error_buffer_init_allocator(error_buffer_t **error_buffer, dynmem_allocator_t *allocator){
+    string_init_allocator((string_t **)error_buffer, allocator);
+}
+
 void error_buffer_destroy(error_buffer_t *error_buffer){
     string_destroy((string_t *)error_buffer);
 }
@@ -15,6 +19,13 @@ char * error_buffer_get(error_buffer_t *error_buffer){
     return string_get(error_buffer);
 }
 
+void error_buffer_clear(error_buffer_t *error_buffer){
+    CHECK_NULL_ARGUMENT(error_buffer);
+
+    error_buffer->length = 0;
+    error_buffer->data[0] = '\0';
+}
+
 void error_buffer_write(error_buffer_t *error_buffer, char *fmt, ...){
     CHECK_NULL_ARGUMENT(fmt);
     CHECK_NULL_ARGUMENT(error_buffer);
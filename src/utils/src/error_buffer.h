@@ -25,6 +25,14 @@ typedef string_t error_buffer_t;
  */
 void error_buffer_init(error_buffer_t **error_buffer);
 
+/**
+ * @brief Initialize string buffer using given allocator.
+ *
+ * @param error_buffer Pointer to buffer to work with.
+ * @param allocator Allocator used for buffer and its messages.
+ */
+void error_buffer_init_allocator(error_buffer_t **error_buffer, dynmem_allocator_t *allocator);
+
 /**
  * @brief Destroy and free memory used by buffer.
  *
@@ -40,6 +48,13 @@ void error_buffer_destroy(error_buffer_t *error_buffer);
  */
 char * error_buffer_get(error_buffer_t *error_buffer);
 
+/**
+ * @brief Remove error message, allocated memory is kept.
+ *
+ * @param error_buffer Pointer to buffer to work with.
+ */
+void error_buffer_clear(error_buffer_t *error_buffer);
+
 /**
  * @brief Append into error message. Each call will be separated with '\r\n'
  * sequence.
@@ -7,38 +7,140 @@
 #include <utillib/core.h>
 
 #include <stdint.h>
+#include <limits.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
 #include <math.h>
 #include <stdio.h>
 
-typedef struct {
+//count of cached results of pure functions in one program, power of two
+#define EVALUATOR_MEMO_SIZE 16
+//calls with more arguments are not cached
+#define EVALUATOR_MEMO_MAX_ARGS 4
+//value is not variable with interned name
+#define EVALUATOR_NO_SYMBOL UINT_MAX
+//first size of symbol cache
+#define EVALUATOR_SYMBOL_CACHE_SIZE 16
+
+struct evaluator_value_s {
     union{
         intmax_t number;
         char *text;
     }payload;
     bool is_num;
-} stack_value_t;
+    unsigned symbol;    //ID of variable name in context resolving it
+};
 
-typedef struct {
+typedef struct evaluator_op_record_s {
     char op;
     int precedence;
     evaluator_op_associativity_t associativity;
     unsigned arg_count;
     bool (*compute_fun)(evaluator_t *this, intmax_t *result, list_t *args);
+    bool (*compute_args_fun)(evaluator_t *this, intmax_t *result, evaluator_args_t args);
+    bool pure;
 } evaluator_op_record_t;
 
 typedef struct {
     char *func;
     unsigned arg_count;
     bool (*compute_fun)(evaluator_t *this, intmax_t *result, list_t *args);
+    bool (*compute_args_fun)(evaluator_t *this, intmax_t *result, evaluator_args_t args);
+    bool pure;
 } evaluator_function_record_t;
 
-static void parse(char *input, queue_t **output);
-static bool sort_infix_to_postfix(evaluator_t *this, queue_t *input, queue_t **output);
-static bool solve(evaluator_t *this, queue_t *rpn_expresion, intmax_t *result);
-static bool _evaluator_convert(evaluator_t *this, stack_value_t *input, intmax_t *output);
+typedef enum {
+    TOKEN_NUMBER,
+    TOKEN_VARIABLE,
+    TOKEN_OPERATOR,
+    TOKEN_FUNCTION,
+    TOKEN_LEFT_PARENTHESIS,
+    TOKEN_RIGHT_PARENTHESIS,
+    TOKEN_UNKNOWN
+} evaluator_token_type_t;
+
+typedef struct {
+    evaluator_token_type_t type;
+    string_view_t text;
+    union{
+        evaluator_op_record_t *op;
+        evaluator_function_record_t *func;
+    }record;
+} evaluator_token_t;
+
+typedef enum {
+    INSTRUCTION_NUMBER,
+    INSTRUCTION_VARIABLE,
+    INSTRUCTION_CALL
+} evaluator_instruction_type_t;
+
+typedef struct {
+    evaluator_instruction_type_t type;
+    union{
+        intmax_t number;
+        struct{
+            char *name;
+            unsigned symbol;
+        }variable;
+        struct{
+            unsigned arg_count;
+            bool (*compute_fun)(evaluator_t *this, intmax_t *result, list_t *args);
+            bool (*compute_args_fun)(evaluator_t *this, intmax_t *result, evaluator_args_t args);
+            bool pure;
+            bool memoize;
+        }call;
+    }payload;
+} evaluator_instruction_t;
+
+typedef struct {
+    unsigned generation;
+    bool (*compute_fun)(evaluator_t *this, intmax_t *result, list_t *args);
+    bool (*compute_args_fun)(evaluator_t *this, intmax_t *result, evaluator_args_t args);
+    unsigned arg_count;
+    intmax_t args[EVALUATOR_MEMO_MAX_ARGS];
+    intmax_t result;
+} evaluator_memo_entry_t;
+
+struct evaluator_program_s {
+    evaluator_t *evaluator;
+    evaluator_instruction_t *code;
+    unsigned code_length;
+    unsigned code_size;
+    evaluator_value_t *stack;
+    unsigned stack_size;
+    char *names;
+    size_t names_size;
+    list_t *args;
+    evaluator_memo_entry_t *memo;
+    unsigned memo_generation;
+    struct evaluator_symbol_names_s *symbol_names;
+    dynmem_allocator_t *allocator;
+};
+
+//names are shared by context and programs compiled with it, so IDs in
+//programs are valid as long as context uses the same names
+typedef struct evaluator_symbol_names_s {
+    string_cache_t *cache;
+    unsigned references;
+} evaluator_symbol_names_t;
+
+typedef struct evaluator_symbol_s {
+    intmax_t value;
+    unsigned generation;
+    bool valid;
+} evaluator_symbol_t;
+
+static void parse(evaluator_context_t *context, char *input, queue_t **output);
+static bool sort_infix_to_postfix(evaluator_t *this, evaluator_context_t *context, queue_t *input, queue_t **output);
+static bool compile(evaluator_t *this, evaluator_context_t *context, char *expresion, dynmem_allocator_t *allocator, evaluator_program_t **program);
+static bool _evaluator_convert(evaluator_t *this, evaluator_context_t *context, evaluator_value_t *input, intmax_t *output);
+static bool _evaluator_variable_callback(void *user_data, char *variable_name, intmax_t *value);
+static bool _call(evaluator_program_t *program, evaluator_context_t *context, evaluator_instruction_t *instruction, evaluator_value_t *args, intmax_t *result);
+static void _append_function(evaluator_t *this, char *func_name, unsigned argc, evaluator_function_record_t *record);
+static void _append_operator(evaluator_t *this, char op, int precedence, evaluator_op_associativity_t associativity, unsigned argc, evaluator_op_record_t *record);
+static void _symbol_names_release(evaluator_symbol_names_t *names);
+static evaluator_symbol_t *_symbol_entry(evaluator_context_t *context, unsigned symbol);
 
 void evaluate_new(evaluator_t **evaluator){
     CHECK_NULL_ARGUMENT(evaluator);
@@ -46,22 +148,32 @@ void evaluate_new(evaluator_t **evaluator){
 
     *evaluator = (evaluator_t *)dynmem_calloc(1, sizeof(evaluator_t));
 
-    (*evaluator)->error_buffer = NULL;
     (*evaluator)->func_records = NULL;
     (*evaluator)->op_records = NULL;
+    (*evaluator)->func_map = NULL;
+    (*evaluator)->variable_resolve_callback = NULL;
+    (*evaluator)->context = NULL;
+
+    for(unsigned i = 0; i < EVALUATOR_OP_TABLE_SIZE; i++){
+        (*evaluator)->op_table[i] = NULL;
+    }
 
-    error_buffer_init(&((*evaluator)->error_buffer));
-    (*evaluator)->error_buffer_allocated = true;
+    evaluate_context_new(&((*evaluator)->context));
 
     list_init(&((*evaluator)->func_records), sizeof(evaluator_function_record_t *));
     list_init(&((*evaluator)->op_records), sizeof(evaluator_op_record_t *));
+    hashmap_init(&((*evaluator)->func_map), sizeof(string_view_t), sizeof(evaluator_function_record_t *), hashmap_hash_view, hashmap_equal_view);
 }
 
 void evaluate_destroy(evaluator_t *evaluator){
     CHECK_NULL_ARGUMENT(evaluator);
 
-    if(evaluator->error_buffer_allocated == true && evaluator->error_buffer != NULL){
-        error_buffer_destroy(evaluator->error_buffer);
+    if(evaluator->context != NULL){
+        evaluate_context_destroy(evaluator->context);
+    }
+
+    if(evaluator->func_map != NULL){
+        hashmap_destroy(evaluator->func_map);
     }
 
     if(evaluator->func_records != NULL){
@@ -90,12 +202,190 @@ void evaluate_error_buffer_set(evaluator_t *evaluator, error_buffer_t *error_buf
     CHECK_NULL_ARGUMENT(evaluator);
     CHECK_NULL_ARGUMENT(error_buffer);
 
-    if(evaluator->error_buffer_allocated == true && evaluator->error_buffer != NULL){
-        error_buffer_destroy(evaluator->error_buffer);
+    evaluate_context_error_buffer_set(evaluator->context, error_buffer);
+}
+
+void evaluate_context_new(evaluator_context_t **context){
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NOT_NULL_ARGUMENT(*context);
+
+    evaluator_context_t *tmp = (evaluator_context_t *)dynmem_calloc(1, sizeof(evaluator_context_t));
+
+    tmp->error_buffer = NULL;
+    tmp->arena = NULL;
+    tmp->user_data = NULL;
+    tmp->variable_resolve_callback = NULL;
+    tmp->symbol_cache = NULL;
+    tmp->symbol_cache_size = 0;
+    tmp->symbol_names = NULL;
+    tmp->symbol_generation = 0;
+    tmp->symbol_cache_hits = 0;
+    tmp->symbol_cache_misses = 0;
+
+    dynmem_arena_init(&(tmp->arena), DYNMEM_ARENA_DEFAULT_CHUNK_SIZE);
+
+    error_buffer_init(&(tmp->error_buffer));
+    tmp->error_buffer_allocated = true;
+
+    *context = tmp;
+}
+
+void evaluate_context_destroy(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+
+    if(context->error_buffer_allocated == true && context->error_buffer != NULL){
+        error_buffer_destroy(context->error_buffer);
+    }
+
+    if(context->arena != NULL){
+        dynmem_arena_destroy(context->arena);
+    }
+
+    evaluate_context_symbol_cache_disable(context);
+
+    dynmem_free(context);
+}
+
+void evaluate_context_error_buffer_set(evaluator_context_t *context, error_buffer_t *error_buffer){
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(error_buffer);
+
+    if(context->error_buffer_allocated == true && context->error_buffer != NULL){
+        error_buffer_destroy(context->error_buffer);
+    }
+
+    context->error_buffer = error_buffer;
+    context->error_buffer_allocated = false;
+}
+
+void evaluate_context_register_variable_callback(
+    evaluator_context_t *context,
+    bool (*variable_resolve_callback)(void *user_data, char *variable_name, intmax_t *value),
+    void *user_data
+){
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(variable_resolve_callback);
+
+    context->variable_resolve_callback = variable_resolve_callback;
+    context->user_data = user_data;
+
+    //values cached from previous callback are not valid
+    context->symbol_generation++;
+}
+
+void evaluate_context_symbol_cache_enable(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+
+    if(context->symbol_names != NULL){
+        return;
+    }
+
+    evaluator_symbol_names_t *names = (evaluator_symbol_names_t *)dynmem_malloc(sizeof(evaluator_symbol_names_t));
+
+    names->cache = NULL;
+    names->references = 1;
+    string_cache_new(&(names->cache));
+
+    //values are indexed by ID of name, table grows when names are interned
+    context->symbol_names = names;
+    context->symbol_cache = NULL;
+    context->symbol_cache_size = 0;
+}
+
+void evaluate_context_symbol_cache_disable(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+
+    if(context->symbol_names == NULL){
+        return;
+    }
+
+    //names can still be referenced by compiled programs
+    _symbol_names_release(context->symbol_names);
+
+    if(context->symbol_cache != NULL){
+        dynmem_free(context->symbol_cache);
     }
 
-    evaluator->error_buffer = error_buffer;
-    evaluator->error_buffer_allocated = false;
+    context->symbol_names = NULL;
+    context->symbol_cache = NULL;
+    context->symbol_cache_size = 0;
+}
+
+void evaluate_context_invalidate_symbol(evaluator_context_t *context, char *variable_name){
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(variable_name);
+
+    if(context->symbol_names == NULL){
+        return;
+    }
+
+    unsigned symbol;
+
+    //name that was never interned has nothing cached
+    if(!string_cache_find(context->symbol_names->cache, string_view_from(variable_name), &symbol)){
+        return;
+    }
+
+    if(symbol < context->symbol_cache_size){
+        context->symbol_cache[symbol].valid = false;
+    }
+}
+
+void evaluate_context_invalidate_symbols(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+
+    //entries are not removed, values from older generation are just ignored
+    context->symbol_generation++;
+}
+
+void evaluate_context_symbol_cache_stats(evaluator_context_t *context, size_t *hits, size_t *misses){
+    CHECK_NULL_ARGUMENT(context);
+
+    if(hits != NULL)
+        *hits = context->symbol_cache_hits;
+
+    if(misses != NULL)
+        *misses = context->symbol_cache_misses;
+}
+
+char *evaluate_context_error(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+    return error_buffer_get(context->error_buffer);
+}
+
+void evaluate_context_clear_error(evaluator_context_t *context){
+    CHECK_NULL_ARGUMENT(context);
+
+    //buffer can be borrowed from caller, so it is only emptied
+    error_buffer_clear(context->error_buffer);
+}
+
+static void _append_function(evaluator_t *this, char *func_name, unsigned argc, evaluator_function_record_t *record){
+    record->arg_count = argc;
+    record->func = dynmem_strdup(func_name);
+
+    list_append(this->func_records, (void *)&record);
+
+    //key refers to name owned by record, first registered function wins
+    string_view_t key = string_view_from(record->func);
+
+    if(!hashmap_contains(this->func_map, &key)){
+        hashmap_set(this->func_map, &key, &record);
+    }
+}
+
+static void _append_operator(evaluator_t *this, char op, int precedence, evaluator_op_associativity_t associativity, unsigned argc, evaluator_op_record_t *record){
+    record->arg_count = argc;
+    record->associativity = associativity;
+    record->op = op;
+    record->precedence = precedence;
+
+    list_append(this->op_records, (void *)&record);
+
+    //first registered operator wins
+    if(this->op_table[(unsigned char)op] == NULL){
+        this->op_table[(unsigned char)op] = record;
+    }
 }
 
 void evaluate_append_function(evaluator_t *this, char *func_name, unsigned argc, bool (*compute_function)()){
@@ -105,11 +395,23 @@ void evaluate_append_function(evaluator_t *this, char *func_name, unsigned argc,
 
     evaluator_function_record_t *new_record = (evaluator_function_record_t *)dynmem_calloc(1, sizeof(evaluator_function_record_t));
 
-    new_record->arg_count = argc;
     new_record->compute_fun = compute_function;
-    new_record->func = dynmem_strdup(func_name);
+    new_record->compute_args_fun = NULL;
 
-    list_append(this->func_records, (void *)&new_record);
+    _append_function(this, func_name, argc, new_record);
+}
+
+void evaluate_append_function_args(evaluator_t *this, char *func_name, unsigned argc, bool (*compute_function)(evaluator_t *this, intmax_t *result, evaluator_args_t args)){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(func_name);
+    CHECK_NULL_ARGUMENT(compute_function);
+
+    evaluator_function_record_t *new_record = (evaluator_function_record_t *)dynmem_calloc(1, sizeof(evaluator_function_record_t));
+
+    new_record->compute_fun = NULL;
+    new_record->compute_args_fun = compute_function;
+
+    _append_function(this, func_name, argc, new_record);
 }
 
 void evaluate_append_operator(evaluator_t *this, char op, int precedence, evaluator_op_associativity_t associativity, unsigned argc, bool (*compute_function)()){
@@ -118,50 +420,179 @@ void evaluate_append_operator(evaluator_t *this, char op, int precedence, evalua
 
     evaluator_op_record_t *new_record = (evaluator_op_record_t *)dynmem_calloc(1, sizeof(evaluator_op_record_t));
 
-    new_record->arg_count = argc;
     new_record->compute_fun = compute_function;
-    new_record->associativity = associativity;
-    new_record->op = op;
-    new_record->precedence = precedence;
+    new_record->compute_args_fun = NULL;
 
-    list_append(this->op_records, (void *)&new_record);
+    _append_operator(this, op, precedence, associativity, argc, new_record);
+}
+
+void evaluate_append_operator_args(evaluator_t *this, char op, int precedence, evaluator_op_associativity_t associativity, unsigned argc, bool (*compute_function)(evaluator_t *this, intmax_t *result, evaluator_args_t args)){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(compute_function);
+
+    evaluator_op_record_t *new_record = (evaluator_op_record_t *)dynmem_calloc(1, sizeof(evaluator_op_record_t));
+
+    new_record->compute_fun = NULL;
+    new_record->compute_args_fun = compute_function;
+
+    _append_operator(this, op, precedence, associativity, argc, new_record);
+}
+
+void evaluate_set_function_pure(evaluator_t *this, char *func_name){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(func_name);
+
+    evaluator_function_record_t *record = NULL;
+    string_view_t key = string_view_from(func_name);
+
+    if(!hashmap_get(this->func_map, &key, &record)){
+        error("Function have to be appended before it is set as pure!");
+    }
+
+    record->pure = true;
+}
+
+void evaluate_set_operator_pure(evaluator_t *this, char op){
+    CHECK_NULL_ARGUMENT(this);
+
+    evaluator_op_record_t *record = this->op_table[(unsigned char)op];
+
+    if(record == NULL){
+        error("Operator have to be appended before it is set as pure!");
+    }
+
+    record->pure = true;
 }
 
 bool evaluate_expression(evaluator_t *this, char *expresion, intmax_t *result){
     CHECK_NULL_ARGUMENT(this);
+
+    return evaluate_expression_context(this, this->context, expresion, result);
+}
+
+bool evaluate_expression_context(evaluator_t *this, evaluator_context_t *context, char *expresion, intmax_t *result){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(context);
     CHECK_NULL_ARGUMENT(expresion);
     CHECK_NULL_ARGUMENT(result);
 
-    queue_t *parsed_tokens = NULL;
-    queue_t *sorted_expresion = NULL;
+    bool retVal = false;
+    evaluator_program_t *program = NULL;
+    dynmem_arena_mark_t mark;
+
+    //everything allocated from arena is released at the end, mark is used
+    //so expression can be evaluated from within callbacks too
+    dynmem_arena_mark(context->arena, &mark);
+
+    if(!compile(this, context, expresion, dynmem_arena_allocator(context->arena), &program)){
+        goto _end;
+    }
+
+    if(!evaluate_run_context(program, context, result)){
+        error_buffer_write(context->error_buffer, "Failed to sort expresion '%s'!", expresion);
+        goto _end;
+    }
+
+    retVal = true;
+
+_end:
+    //program is allocated from arena, so there is no need to destroy it,
+    //only names it refers to are released
+    if(program != NULL && program->symbol_names != NULL){
+        _symbol_names_release(program->symbol_names);
+    }
+
+    dynmem_arena_rewind(context->arena, &mark);
+
+    return retVal;
+}
 
-    parse(expresion, &parsed_tokens);
+bool evaluate_expression_batch(evaluator_t *this, char **exprs, size_t n, intmax_t *results, bool *ok){
+    CHECK_NULL_ARGUMENT(this);
+
+    return evaluate_expression_batch_context(this, this->context, exprs, n, results, ok);
+}
+
+bool evaluate_expression_batch_context(evaluator_t *this, evaluator_context_t *context, char **exprs, size_t n, intmax_t *results, bool *ok){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(exprs);
+    CHECK_NULL_ARGUMENT(results);
+
+    bool retVal = true;
 
-    if(!sort_infix_to_postfix(this, parsed_tokens, &sorted_expresion)){
-        error_buffer_write(this->error_buffer, "Failed to convert expresion '%s' to postfix notation!", expresion);
+    //symbol cache is used for the batch only, if it isn't enabled already
+    bool temporary_cache = (context->symbol_names == NULL);
+
+    if(temporary_cache){
+        evaluate_context_symbol_cache_enable(context);
+    }
 
-        tokenizer_clean_output_queue(parsed_tokens);
+    for(size_t i = 0; i < n; i++){
+        CHECK_NULL_ARGUMENT(exprs[i]);
 
-        if(sorted_expresion != NULL){
-            queue_destroy(sorted_expresion);
+        bool expresion_ok = evaluate_expression_context(this, context, exprs[i], &(results[i]));
+
+        if(ok != NULL){
+            ok[i] = expresion_ok;
         }
 
-        return false;
+        if(!expresion_ok){
+            retVal = false;
+        }
     }
 
-    if(!solve(this, sorted_expresion, result)){
-        error_buffer_write(this->error_buffer, "Failed to sort expresion '%s'!", expresion);
+    if(temporary_cache){
+        evaluate_context_symbol_cache_disable(context);
+    }
 
-        tokenizer_clean_output_queue(parsed_tokens);
-        queue_destroy(sorted_expresion);
+    return retVal;
+}
 
-        return false;
+bool evaluate_compile(evaluator_t *this, char *expresion, evaluator_program_t **program){
+    CHECK_NULL_ARGUMENT(this);
+
+    return evaluate_compile_context(this, this->context, expresion, program);
+}
+
+bool evaluate_compile_context(evaluator_t *this, evaluator_context_t *context, char *expresion, evaluator_program_t **program){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(expresion);
+    CHECK_NULL_ARGUMENT(program);
+    CHECK_NOT_NULL_ARGUMENT(*program);
+
+    dynmem_arena_mark_t mark;
+    dynmem_arena_mark(context->arena, &mark);
+
+    bool retVal = compile(this, context, expresion, dynmem_allocator_default(), program);
+
+    dynmem_arena_rewind(context->arena, &mark);
+
+    return retVal;
+}
+
+void evaluate_program_destroy(evaluator_program_t *program){
+    CHECK_NULL_ARGUMENT(program);
+
+    dynmem_allocator_t *allocator = program->allocator;
+
+    if(program->args != NULL){
+        list_destroy(program->args);
     }
 
-    tokenizer_clean_output_queue(parsed_tokens);
-    queue_destroy(sorted_expresion);
+    if(program->memo != NULL){
+        dynmem_allocator_free(allocator, program->memo, EVALUATOR_MEMO_SIZE * sizeof(evaluator_memo_entry_t));
+    }
 
-    return true;
+    if(program->symbol_names != NULL){
+        _symbol_names_release(program->symbol_names);
+    }
+
+    dynmem_allocator_free(allocator, program->names, program->names_size);
+    dynmem_allocator_free(allocator, program->stack, program->stack_size * sizeof(evaluator_value_t));
+    dynmem_allocator_free(allocator, program->code, program->code_size * sizeof(evaluator_instruction_t));
+    dynmem_allocator_free(allocator, program, sizeof(evaluator_program_t));
 }
 
 bool evaluate_expression_string(evaluator_t *this, string_t *expresion, intmax_t *result){
@@ -174,15 +605,13 @@ bool evaluate_expression_string(evaluator_t *this, string_t *expresion, intmax_t
 
 char *evaluate_error(evaluator_t *this){
     CHECK_NULL_ARGUMENT(this);
-    return error_buffer_get(this->error_buffer);
+    return evaluate_context_error(this->context);
 }
 
 void evaluate_clear_error(evaluator_t *this){
     CHECK_NULL_ARGUMENT(this);
 
-    error_buffer_destroy(this->error_buffer);
-    this->error_buffer = NULL;
-    error_buffer_init(&(this->error_buffer));
+    evaluate_context_clear_error(this->context);
 }
 
 bool evaluator_convert(evaluator_t *this, list_t *args, unsigned int arg_pos, intmax_t *output){
@@ -190,10 +619,21 @@ bool evaluator_convert(evaluator_t *this, list_t *args, unsigned int arg_pos, in
     CHECK_NULL_ARGUMENT(args);
     CHECK_NULL_ARGUMENT(output);
 
-    stack_value_t *input = NULL;
+    evaluator_value_t *input = NULL;
     list_at(args, arg_pos, &input);
 
-    return _evaluator_convert(this, input, output);
+    return _evaluator_convert(this, this->context, input, output);
+}
+
+bool evaluator_convert_arg(evaluator_t *this, evaluator_args_t args, unsigned int arg_pos, intmax_t *output){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(output);
+
+    if(arg_pos >= args.count){
+        error("Argument position is out of range!");
+    }
+
+    return _evaluator_convert(this, args.context, &(args.values[arg_pos]), output);
 }
 
 void evaluate_register_variable_callback(evaluator_t *this, bool (*variable_resolve_callback)(char *variable_name, intmax_t *value)){
@@ -201,146 +641,227 @@ void evaluate_register_variable_callback(evaluator_t *this, bool (*variable_reso
     CHECK_NULL_ARGUMENT(variable_resolve_callback);
 
     this->variable_resolve_callback = variable_resolve_callback;
+    evaluate_context_register_variable_callback(this->context, _evaluator_variable_callback, (void *)this);
 }
 
-//------------------------------------------------------------------------------
-// common
+void evaluate_symbol_cache_enable(evaluator_t *this){
+    CHECK_NULL_ARGUMENT(this);
+
+    evaluate_context_symbol_cache_enable(this->context);
+}
 
-static bool is_function(evaluator_t *this, char *s){
-    CHECK_NULL_ARGUMENT(s);
+void evaluate_symbol_cache_disable(evaluator_t *this){
     CHECK_NULL_ARGUMENT(this);
 
-    for(unsigned int i = 0; i < list_count(this->func_records); i++){
-        evaluator_function_record_t *head = NULL;
-        list_at(this->func_records, i, &head);
+    evaluate_context_symbol_cache_disable(this->context);
+}
 
-        if(strcmp(head->func, s) == 0){
-            return true;
-        }
-    }
+void evaluate_invalidate_symbol(evaluator_t *this, char *variable_name){
+    CHECK_NULL_ARGUMENT(this);
 
-    return false;
+    evaluate_context_invalidate_symbol(this->context, variable_name);
 }
 
-static bool is_operator(evaluator_t *this, char *s){
+void evaluate_invalidate_symbols(evaluator_t *this){
     CHECK_NULL_ARGUMENT(this);
 
-    if(strlen(s) != 1){
-        return false;
-    }
+    evaluate_context_invalidate_symbols(this->context);
+}
 
-    for(unsigned int i = 0; i < list_count(this->op_records); i++){
-        evaluator_op_record_t *head = NULL;
-        list_at(this->op_records, i, &head);
+void evaluate_symbol_cache_stats(evaluator_t *this, size_t *hits, size_t *misses){
+    CHECK_NULL_ARGUMENT(this);
 
-        if(s[0] == head->op){
-            return true;
-        }
-    }
+    evaluate_context_symbol_cache_stats(this->context, hits, misses);
+}
 
-    return false;
+static bool _evaluator_variable_callback(void *user_data, char *variable_name, intmax_t *value){
+    evaluator_t *this = (evaluator_t *)user_data;
+
+    return (*this->variable_resolve_callback)(variable_name, value);
 }
 
-static evaluator_op_record_t *get_op_record(evaluator_t *this, char *s){
-    CHECK_NULL_ARGUMENT(this);
-    CHECK_NULL_ARGUMENT(s);
+//------------------------------------------------------------------------------
+// common
 
-    if(strlen(s) != 1){
-        error("Operator can be only one char!");
-    }
+static evaluator_function_record_t *find_function(evaluator_t *this, string_view_t s){
+    evaluator_function_record_t *record = NULL;
 
-    for(unsigned int i = 0; i < list_count(this->op_records); i++){
-        evaluator_op_record_t *head = NULL;
-        list_at(this->op_records, i, &head);
+    hashmap_get(this->func_map, &s, &record);
 
-        if(s[0] == head->op){
-            return head;
-        }
+    return record;
+}
+
+static evaluator_op_record_t *find_operator(evaluator_t *this, string_view_t s){
+    if(s.length != 1){
+        return NULL;
     }
 
-    error("Can't found operator! Use is_operator() before calling get_op_record()!");
+    return this->op_table[(unsigned char)s.data[0]];
 }
 
-static evaluator_function_record_t *get_func_record(evaluator_t *this, char *s){
-    CHECK_NULL_ARGUMENT(this);
-    CHECK_NULL_ARGUMENT(s);
-
-    for(unsigned int i = 0; i < list_count(this->func_records); i++){
-        evaluator_function_record_t *head = NULL;
-        list_at(this->func_records, i, &head);
+static bool is_identifier(string_view_t s){
+    for(size_t i = 0; i < s.length; i++){
+        unsigned char x = (unsigned char)s.data[i];
+        if((isalnum(x) == 0) && (x != '_') && (i > 0))
+            return false;
 
-        if(strcmp(head->func, s) == 0){
-            return head;
-        }
+        if((isalpha(x) == 0) && (x != '_') && (i == 0))
+            return false;
     }
 
-    error("Can't found operator! Use is_function() before calling get_func_record()!");
+    return true;
 }
 
-static bool can_be_variable(evaluator_t *this, char *s){
-    if(s == NULL)
+static bool can_be_variable(evaluator_t *this, string_view_t s){
+    if(find_operator(this, s) != NULL){
         return false;
-
-    if(strlen(s) == 1){
-        if(is_operator(this, s) == true){
-            return false;
-        }
     }
 
-    if(is_function(this, s) == true){
+    if(find_function(this, s) != NULL){
         return false;
     }
 
-    for(unsigned i = 0; s[i] != '\0'; i++){
-        char x = s[i];
-        if((isalnum(x) == 0) && (x != '_') && (i > 0))
-            return false;
+    return is_identifier(s);
+}
 
-        if((isalpha(x) == 0) && (x != '_') && (i == 0))
-            return false;
+static void classify(evaluator_t *this, string_view_t s, evaluator_token_t *token){
+    token->text = s;
+
+    if(is_number_view(s)){
+        token->type = TOKEN_NUMBER;
     }
+    else if((token->record.func = find_function(this, s)) != NULL){
+        token->type = TOKEN_FUNCTION;
+    }
+    else if((token->record.op = find_operator(this, s)) != NULL){
+        token->type = TOKEN_OPERATOR;
+    }
+    else if(is_identifier(s)){
+        token->type = TOKEN_VARIABLE;
+    }
+    else if(s.length == 1 && s.data[0] == '('){
+        token->type = TOKEN_LEFT_PARENTHESIS;
+    }
+    else if(s.length == 1 && s.data[0] == ')'){
+        token->type = TOKEN_RIGHT_PARENTHESIS;
+    }
+    else{
+        token->type = TOKEN_UNKNOWN;
+    }
+}
 
-    return true;
+static void _symbol_names_release(evaluator_symbol_names_t *names){
+    names->references--;
+
+    if(names->references == 0){
+        string_cache_destroy(names->cache);
+        dynmem_free(names);
+    }
 }
 
-static bool _evaluator_convert(evaluator_t *this, stack_value_t *input, intmax_t *output){
+static evaluator_symbol_t *_symbol_entry(evaluator_context_t *context, unsigned symbol){
+    if(context->symbol_names == NULL || symbol == EVALUATOR_NO_SYMBOL){
+        return NULL;
+    }
+
+    if(symbol >= context->symbol_cache_size){
+        unsigned size = (context->symbol_cache_size != 0) ? context->symbol_cache_size : EVALUATOR_SYMBOL_CACHE_SIZE;
+
+        while(size <= symbol){
+            size *= 2;
+        }
+
+        if(context->symbol_cache == NULL)
+            context->symbol_cache = (evaluator_symbol_t *)dynmem_malloc(size * sizeof(evaluator_symbol_t));
+        else
+            context->symbol_cache = (evaluator_symbol_t *)dynmem_realloc(context->symbol_cache, size * sizeof(evaluator_symbol_t));
+
+        memset(&(context->symbol_cache[context->symbol_cache_size]), 0, (size - context->symbol_cache_size) * sizeof(evaluator_symbol_t));
+        context->symbol_cache_size = size;
+    }
+
+    return &(context->symbol_cache[symbol]);
+}
+
+static bool _evaluator_convert(evaluator_t *this, evaluator_context_t *context, evaluator_value_t *input, intmax_t *output){
     if(input->is_num == true){
         *output =  input->payload.number;
         return true;
     }
-    else{
-        if(is_number(input->payload.text)){
-            str_to_num_signed(input->payload.text, output);
+
+    unsigned symbol = input->symbol;
+
+    //variables of compiled program are known by ID, others are checked and interned here
+    if(symbol == EVALUATOR_NO_SYMBOL){
+        string_view_t text = string_view_from(input->payload.text);
+
+        if(is_number_view(text)){
+            str_to_num_signed_view(text, output);
             return true;
         }
 
-        if(can_be_variable(this, input->payload.text)){
-            if(this->variable_resolve_callback != NULL){
-                if((*this->variable_resolve_callback)(input->payload.text, output) == true){
-                    return true;
-                }
-                else{
-                    error_buffer_write(this->error_buffer, "Variable '%s' cannot be resolved!", input->payload.text);
-                }
+        if(!can_be_variable(this, text)){
+            error_buffer_write(context->error_buffer, "Cannot resolve argument '%s'.", input->payload.text);
+            return false;
+        }
+
+        if(context->symbol_names != NULL){
+            symbol = string_cache_intern(context->symbol_names->cache, text);
+        }
+    }
+
+    evaluator_symbol_t *entry = _symbol_entry(context, symbol);
+
+    if(entry != NULL){
+        if(entry->valid && entry->generation == context->symbol_generation){
+            context->symbol_cache_hits++;
+            *output = entry->value;
+            return true;
+        }
+
+        context->symbol_cache_misses++;
+    }
+
+    if(context->variable_resolve_callback != NULL){
+        if((*context->variable_resolve_callback)(context->user_data, input->payload.text, output) == true){
+            //callback can evaluate other expressions in context, so entry is found again
+            entry = _symbol_entry(context, symbol);
+
+            if(entry != NULL){
+                entry->value = *output;
+                entry->generation = context->symbol_generation;
+                entry->valid = true;
             }
+
+            return true;
+        }
+        else{
+            error_buffer_write(context->error_buffer, "Variable '%s' cannot be resolved!", input->payload.text);
         }
-        error_buffer_write(this->error_buffer, "Cannot resolve argument '%s'.", input->payload.text);
     }
 
+    error_buffer_write(context->error_buffer, "Cannot resolve argument '%s'.", input->payload.text);
+
     return false;
 }
 
 //------------------------------------------------------------------------------
 // Parsing
 
-static void parse(char *input, queue_t **output){
+static void parse(evaluator_context_t *context, char *input, queue_t **output){
     CHECK_NULL_ARGUMENT(input);
     CHECK_NULL_ARGUMENT(output);
     CHECK_NOT_NULL_ARGUMENT(*output);
 
     tokenizer_t *tokenizer = NULL;
 
-    tokenizer_init(&tokenizer);
+    queue_init_allocator(output, sizeof(token_t *), LIST_BACKEND_CHUNKED, dynmem_arena_allocator(context->arena));
+
+    //expression outlive tokens, so tokens can refer to it, tokenizer itself
+    //is released together with tokens so evaluation doesn't touch heap
+    tokenizer_init_allocator(&tokenizer, dynmem_arena_allocator(context->arena));
+    tokenizer_config_arena(tokenizer, context->arena);
+    tokenizer_config_retain_input(tokenizer);
     tokenizer_tokenize_char_string(tokenizer, input);
     tokenizer_end(tokenizer, output);
 }
@@ -348,27 +869,13 @@ static void parse(char *input, queue_t **output){
 //------------------------------------------------------------------------------
 // Sorting infix to postfix
 
-static bool is_right_parenthesis(char *s){
-    if(strcmp(s, ")") == 0)
-        return true;
-    else
-        return false;
-}
-
-static bool is_left_parenthesis(char *s){
-    if(strcmp(s, "(") == 0)
-        return true;
-    else
-        return false;
-}
-
-static char *stack_char_peek(stack_t *stack){
-    char *ptr = NULL;
-    stack_peek(stack, (void *)&ptr);
-    return ptr;
+static evaluator_token_type_t stack_peek_type(stack_t *stack){
+    evaluator_token_t token;
+    stack_peek(stack, (void *)&token);
+    return token.type;
 }
 
-static bool sort_infix_to_postfix(evaluator_t *this, queue_t *input, queue_t **output){
+static bool sort_infix_to_postfix(evaluator_t *this, evaluator_context_t *context, queue_t *input, queue_t **output){
     CHECK_NULL_ARGUMENT(input);
     CHECK_NULL_ARGUMENT(output);
     CHECK_NOT_NULL_ARGUMENT(*output);
@@ -376,89 +883,91 @@ static bool sort_infix_to_postfix(evaluator_t *this, queue_t *input, queue_t **o
     bool retVal = false;
     stack_t *operator_stack = NULL;
 
-    stack_init(&operator_stack, sizeof(char *));
-    queue_init(output, sizeof(char *));
-
-    for(unsigned int i = 0; i < list_count(input); i++){
-        token_t *token = NULL;
-        list_at((list_t *)input, i, (void *)&token);
+    list_iter_t it;
+
+    stack_init_allocator(&operator_stack, sizeof(evaluator_token_t), LIST_BACKEND_LINKED, dynmem_arena_allocator(context->arena));
+    queue_init_allocator(output, sizeof(evaluator_token_t), LIST_BACKEND_CHUNKED, dynmem_arena_allocator(context->arena));
+
+    for(list_iter_begin((list_t *)input, &it); list_iter_valid(&it); list_iter_next(&it)){
+        token_t *raw_token = NULL;
+        list_iter_get(&it, (void *)&raw_token);
+
+        //token is classified only once, records are carried with it
+        evaluator_token_t token;
+        classify(this, raw_token->text, &token);
+
+        switch(token.type){
+            case TOKEN_NUMBER:
+            case TOKEN_VARIABLE:
+                queue_append((*output), &token);
+                break;
+
+            case TOKEN_FUNCTION:
+            case TOKEN_LEFT_PARENTHESIS:
+                stack_push(operator_stack, &token);
+                break;
+
+            case TOKEN_OPERATOR:
+                while(stack_count(operator_stack) > 0 && stack_peek_type(operator_stack) != TOKEN_LEFT_PARENTHESIS){
+                    evaluator_token_t top;
+                    stack_peek(operator_stack, (void *)&top);
+
+                    //function without parentheses bind tighter than any operator
+                    if(top.type == TOKEN_OPERATOR){
+                        if(token.record.op->associativity == left){
+                            if(token.record.op->precedence > top.record.op->precedence)
+                                break;
+                        }
+                        else{
+                            if(token.record.op->precedence >= top.record.op->precedence)
+                                break;
+                        }
+                    }
 
-        if(is_number(token->token)){
-            queue_append((*output), &token->token);
-        }
-        else if(is_function(this, token->token)){
-            stack_push(operator_stack, &token->token);
-        }
-        else if(can_be_variable(this, token->token)){
-            stack_push((*output), &token->token);
-        }
-        else if(is_operator(this, token->token)){
-            while(stack_count(operator_stack) > 0 && !is_left_parenthesis(stack_char_peek(operator_stack))){
-                evaluator_op_record_t *token_record = get_op_record(this, token->token);
-                evaluator_op_record_t *stack_record = get_op_record(this, stack_char_peek(operator_stack));
-
-                if(token_record->associativity == left){
-                    if(token_record->precedence <= stack_record->precedence){
-                        char *data = NULL;
-                        stack_pop(operator_stack, &data);
-                        queue_append((*output), &data);
+                    stack_pop(operator_stack, &top);
+                    queue_append((*output), &top);
+                }
+                stack_push(operator_stack, &token);
+                break;
+
+            case TOKEN_RIGHT_PARENTHESIS:{
+                while(stack_peek_type(operator_stack) != TOKEN_LEFT_PARENTHESIS){
+                    if(stack_count(operator_stack) == 0){
+                        error_buffer_write(context->error_buffer, "Misleaded parentheses in expression processing!");
+                        goto _end;
                     }
                     else{
-                        break;
-                    }
-                }
-                else{
-                    if(token_record->precedence < stack_record->precedence){
-                        char *data = NULL;
+                        evaluator_token_t data;
                         stack_pop(operator_stack, &data);
                         queue_append((*output), &data);
                     }
-                    else{
-                        break;
-                    }
                 }
-            }
-            stack_push(operator_stack, &token->token);
-        }
-        else if(is_left_parenthesis(token->token)){
-            stack_push(operator_stack, &token->token);
-        }
-        else if(is_right_parenthesis(token->token)){
-            while(!is_left_parenthesis(stack_char_peek(operator_stack))){
-                if(stack_count(operator_stack) == 0){
-                    error_buffer_write(this->error_buffer, "Misleaded parentheses in expression processing!");
-                    goto _end;
-                }
-                else{
-                    char *data = NULL;
-                    stack_pop(operator_stack, &data);
-                    queue_append((*output), &data);
-                }
-            }
 
-            volatile char *to_delete = NULL;
-            stack_pop(operator_stack, &to_delete);
+                evaluator_token_t to_delete;
+                stack_pop(operator_stack, &to_delete);
 
-            if(stack_count(operator_stack) > 0){
-                if(is_function(this, stack_char_peek(operator_stack))){
-                    char *data = NULL;
-                    stack_pop(operator_stack, &data);
-                    queue_append((*output), &data);
+                if(stack_count(operator_stack) > 0){
+                    if(stack_peek_type(operator_stack) == TOKEN_FUNCTION){
+                        evaluator_token_t data;
+                        stack_pop(operator_stack, &data);
+                        queue_append((*output), &data);
+                    }
                 }
+                break;
             }
-        }
-        else{
-            error_buffer_write(this->error_buffer, "Found token that is not recognized! Token: '%s'.", token->token);
-            goto _end;
+
+            default:
+                error_buffer_write(context->error_buffer, "Found token that is not recognized! Token: '%.*s'.", (int)token.text.length, token.text.data);
+                goto _end;
         }
     }
 
     while(stack_count(operator_stack) > 0){
-        char *token = NULL;
+        evaluator_token_t token;
         stack_pop(operator_stack, &token);
 
-        if(is_left_parenthesis(token) || is_right_parenthesis(token)){
-            error_buffer_write(this->error_buffer, "Misleaded parentheses in expression processing!");
+        if(token.type == TOKEN_LEFT_PARENTHESIS || token.type == TOKEN_RIGHT_PARENTHESIS){
+            error_buffer_write(context->error_buffer, "Misleaded parentheses in expression processing!");
             goto _end;
         }
 
@@ -473,195 +982,483 @@ _end:
 }
 
 //------------------------------------------------------------------------------
-// solver
+// compiler
+
+static bool compile(evaluator_t *this, evaluator_context_t *context, char *expresion, dynmem_allocator_t *allocator, evaluator_program_t **program){
+    CHECK_NULL_ARGUMENT(this);
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(expresion);
+    CHECK_NULL_ARGUMENT(allocator);
+    CHECK_NULL_ARGUMENT(program);
 
-static void append_to_stack_from_string(stack_t *stack, char *string, queue_t *to_free){
-    CHECK_NULL_ARGUMENT(stack);
-    CHECK_NULL_ARGUMENT(string);
-    CHECK_NULL_ARGUMENT(to_free);
+    bool retVal = false;
+    queue_t *parsed_tokens = NULL;
+    queue_t *sorted_expresion = NULL;
+    error_buffer_t *fold_errors = NULL;
+    list_iter_t it;
 
-    stack_value_t *value = dynmem_calloc(1, sizeof(stack_value_t));
-    value->is_num = false;
-    value->payload.text = string;
+    //tokens and sorted expression are taken from arena, caller rewind it
+    parse(context, expresion, &parsed_tokens);
 
-    queue_append(to_free, (void *)&value);
-    stack_push(stack, (void *)&value);
-}
+    if(!sort_infix_to_postfix(this, context, parsed_tokens, &sorted_expresion)){
+        error_buffer_write(context->error_buffer, "Failed to convert expresion '%s' to postfix notation!", expresion);
+        goto _end;
+    }
 
-static void append_to_stack_from_number(stack_t *stack, intmax_t number, queue_t *to_free){
-    CHECK_NULL_ARGUMENT(stack);
-    CHECK_NULL_ARGUMENT(to_free);
+    //first pass check syntax and compute sizes
+    unsigned code_length = queue_count(sorted_expresion);
+    unsigned depth = 0;
+    unsigned stack_size = 1;
+    size_t names_size = 0;
+    bool needs_list = false;
 
-    stack_value_t *value = dynmem_calloc(1, sizeof(stack_value_t));
-    value->is_num = true;
-    value->payload.number = number;
+    for(list_iter_begin((list_t *)sorted_expresion, &it); list_iter_valid(&it); list_iter_next(&it)){
+        evaluator_token_t token;
+        list_iter_get(&it, (void *)&token);
 
-    queue_append(to_free, (void *)&value);
-    stack_push(stack, (void *)&value);
-}
+        if(token.type == TOKEN_NUMBER){
+            depth++;
+        }
+        else if(token.type == TOKEN_VARIABLE){
+            names_size += token.text.length + 1;
+            depth++;
+        }
+        else if(token.type == TOKEN_OPERATOR || token.type == TOKEN_FUNCTION){
+            unsigned argc_needed = (token.type == TOKEN_FUNCTION) ?
+                token.record.func->arg_count : token.record.op->arg_count;
 
-static bool solve(evaluator_t *this, queue_t *rpn_expresion, intmax_t *result){
-    CHECK_NULL_ARGUMENT(this);
-    CHECK_NULL_ARGUMENT(rpn_expresion);
-    CHECK_NULL_ARGUMENT(result);
+            if(token.type == TOKEN_FUNCTION ? (token.record.func->compute_fun != NULL) : (token.record.op->compute_fun != NULL)){
+                needs_list = true;
+            }
 
-    bool retVal = false;
+            if(argc_needed > depth){
+                error_buffer_write(context->error_buffer, "Not enough values in stack! This mean syntax error in expresion!");
+                error_buffer_write(context->error_buffer, "Failed to sort expresion '%s'!", expresion);
+                goto _end;
+            }
+
+            depth = depth - argc_needed + 1;
+        }
+        else{
+            error_buffer_write(context->error_buffer, "Found token that is not recognized! This mean syntax error in expresion!");
+            error_buffer_write(context->error_buffer, "Failed to sort expresion '%s'!", expresion);
+            goto _end;
+        }
+
+        if(depth > stack_size)
+            stack_size = depth;
+    }
+
+    if(depth != 1){
+        if(depth > 1)
+            error_buffer_write(context->error_buffer, "Some values left in stacks after computation done! Probably syntax error!");
+        else
+            error_buffer_write(context->error_buffer, "No result is found on stack! This mean syntax error in expresion!");
+
+        error_buffer_write(context->error_buffer, "Failed to sort expresion '%s'!", expresion);
+        goto _end;
+    }
+
+    //second pass emit code, operators and functions are resolved here
+    evaluator_program_t *tmp = (evaluator_program_t *)dynmem_allocator_alloc(allocator, sizeof(evaluator_program_t));
+
+    tmp->evaluator = this;
+    tmp->allocator = allocator;
+    tmp->code_length = 0;
+    tmp->code_size = code_length;
+    tmp->code = (evaluator_instruction_t *)dynmem_allocator_alloc(allocator, code_length * sizeof(evaluator_instruction_t));
+    tmp->stack_size = stack_size;
+    tmp->stack = (evaluator_value_t *)dynmem_allocator_alloc(allocator, stack_size * sizeof(evaluator_value_t));
+    tmp->names_size = names_size;
+    tmp->names = (names_size != 0) ? (char *)dynmem_allocator_alloc(allocator, names_size) : NULL;
+    tmp->args = NULL;
+    tmp->memo = NULL;
+    tmp->memo_generation = 0;
+    tmp->symbol_names = context->symbol_names;
+
+    if(tmp->symbol_names != NULL){
+        tmp->symbol_names->references++;
+    }
+
+    //list is needed only for callbacks taking list_t, its items are recycled
+    //so running program doesn't allocate
+    if(needs_list){
+        list_init_allocator(&(tmp->args), sizeof(evaluator_value_t *), LIST_BACKEND_LINKED, allocator);
+        list_config_pool(tmp->args, stack_size);
+    }
+
+    char *name = tmp->names;
+    bool needs_memo = false;
+
+    for(list_iter_begin((list_t *)sorted_expresion, &it); list_iter_valid(&it); list_iter_next(&it)){
+        evaluator_token_t token;
+        list_iter_get(&it, (void *)&token);
+
+        evaluator_instruction_t *instruction = &(tmp->code[tmp->code_length]);
 
-    stack_t *stack = NULL;
-    stack_init(&stack, sizeof(void *));
+        switch(token.type){
+            case TOKEN_NUMBER:
+                instruction->type = INSTRUCTION_NUMBER;
+                str_to_num_signed_view(token.text, &(instruction->payload.number));
+                break;
 
-    queue_t *to_free = NULL;
-    queue_init(&to_free, sizeof(void *));
+            case TOKEN_VARIABLE:
+                instruction->type = INSTRUCTION_VARIABLE;
+                instruction->payload.variable.name = name;
+                instruction->payload.variable.symbol = EVALUATOR_NO_SYMBOL;
 
-    for(unsigned int i = 0; i < list_count(rpn_expresion); i++){
-        char *token = NULL;
-        list_at((list_t *)rpn_expresion, i, (void *)&token);
+                //name is interned once here, so running program doesn't hash it
+                if(context->symbol_names != NULL){
+                    instruction->payload.variable.symbol = string_cache_intern(context->symbol_names->cache, token.text);
+                }
 
-        if(is_number(token)){
-            append_to_stack_from_string(stack, token, to_free);
+                memcpy(name, token.text.data, token.text.length);
+                name[token.text.length] = '\0';
+                name += token.text.length + 1;
+                break;
+
+            case TOKEN_FUNCTION:
+                instruction->type = INSTRUCTION_CALL;
+                instruction->payload.call.arg_count = token.record.func->arg_count;
+                instruction->payload.call.compute_fun = token.record.func->compute_fun;
+                instruction->payload.call.compute_args_fun = token.record.func->compute_args_fun;
+                instruction->payload.call.pure = token.record.func->pure;
+                //only functions are worth caching, operators are cheaper than lookup
+                instruction->payload.call.memoize = token.record.func->pure && token.record.func->arg_count <= EVALUATOR_MEMO_MAX_ARGS;
+                break;
+
+            default:
+                instruction->type = INSTRUCTION_CALL;
+                instruction->payload.call.arg_count = token.record.op->arg_count;
+                instruction->payload.call.compute_fun = token.record.op->compute_fun;
+                instruction->payload.call.compute_args_fun = token.record.op->compute_args_fun;
+                instruction->payload.call.pure = token.record.op->pure;
+                instruction->payload.call.memoize = false;
+                break;
         }
-        else if(can_be_variable(this, token)){
-            append_to_stack_from_string(stack, token, to_free);
+
+        tmp->code_length++;
+
+        if(instruction->type != INSTRUCTION_CALL)
+            continue;
+
+        //pure call of constants is replaced by its result, arguments are
+        //the last emitted instructions, so whole constant subtrees fold
+        unsigned argc = instruction->payload.call.arg_count;
+        bool constant = instruction->payload.call.pure;
+
+        for(unsigned j = 1; constant && j <= argc; j++){
+            if(instruction[-(int)j].type != INSTRUCTION_NUMBER)
+                constant = false;
         }
-        else if(is_operator(this, token) || is_function(this, token)){
-            bool (*func)(evaluator_t *this, intmax_t *result, list_t *args) = NULL;
-            unsigned int argc_needed = 0;
-
-            if(is_operator(this, token)){
-                evaluator_op_record_t *op_record = get_op_record(this, token);
-                func = op_record->compute_fun;
-                argc_needed = op_record->arg_count;
-            }
 
-            if(is_function(this, token)){
-                evaluator_function_record_t *func_record = get_func_record(this, token);
-                func = func_record->compute_fun;
-                argc_needed = func_record->arg_count;
-            }
+        if(constant){
+            intmax_t value = 0;
 
-            if(argc_needed > stack_count(stack)){
-                error_buffer_write(this->error_buffer, "Not enough values in stack! This mean syntax error in expresion!");
-                goto _end;
+            for(unsigned j = 0; j < argc; j++){
+                tmp->stack[j].is_num = true;
+                tmp->stack[j].payload.number = instruction[(int)j - (int)argc].payload.number;
             }
 
-            list_t *args = NULL;
-            list_init(&args, sizeof(stack_value_t *));
+            //failing call is kept in program, so it fails when program is run
+            if(fold_errors == NULL)
+                error_buffer_init_allocator(&fold_errors, dynmem_arena_allocator(context->arena));
 
-            intmax_t op_result = 0;
+            error_buffer_t *errors = context->error_buffer;
+            context->error_buffer = fold_errors;
 
-            for(unsigned int i = 0; i < argc_needed; i++){
-                stack_value_t *tmp = NULL;
-                stack_pop(stack, &tmp);
-                list_insert(args, 0, &tmp); //reverse order of arguments
-            }
+            constant = _call(tmp, context, instruction, tmp->stack, &value);
 
-            if(!(*(func))(this, &op_result, args)){
-                goto _end;
-            }
+            context->error_buffer = errors;
 
-            //objects that was in this list will be free using to_free list
-            list_destroy(args);
+            if(constant){
+                tmp->code_length -= argc + 1;
+                instruction = &(tmp->code[tmp->code_length]);
 
-            append_to_stack_from_number(stack, op_result, to_free);
+                instruction->type = INSTRUCTION_NUMBER;
+                instruction->payload.number = value;
+
+                tmp->code_length++;
+                continue;
+            }
         }
-        else{
-            error_buffer_write(this->error_buffer, "Found token that is not recognized! This mean syntax error in expresion!");
-            goto _end;
+
+        if(instruction->payload.call.memoize)
+            needs_memo = true;
+    }
+
+    if(needs_memo){
+        tmp->memo = (evaluator_memo_entry_t *)dynmem_allocator_alloc(allocator, EVALUATOR_MEMO_SIZE * sizeof(evaluator_memo_entry_t));
+
+        for(unsigned i = 0; i < EVALUATOR_MEMO_SIZE; i++){
+            tmp->memo[i].generation = 0;
         }
     }
 
-    if(stack_count(stack) > 1){
-        error_buffer_write(this->error_buffer, "Some values left in stacks after computation done! Probably syntax error!");
-        goto _end;
+    *program = tmp;
+    retVal = true;
+
+_end:
+    queue_destroy(parsed_tokens);
+
+    if(sorted_expresion != NULL){
+        queue_destroy(sorted_expresion);
     }
-    else if(stack_count(stack) == 0){
-        error_buffer_write(this->error_buffer, "No result is found on stack! This mean syntax error in expresion!");
-        goto _end;
+
+    if(fold_errors != NULL){
+        error_buffer_destroy(fold_errors);
     }
-    else{
-        stack_value_t *tmp = NULL;
-        stack_pop(stack, (void *)&tmp);
 
-        if(!_evaluator_convert(this, tmp, result)){
-            error_buffer_write(this->error_buffer, "Can't get result from stack! This mean syntax error in expresion!");
-            goto _end;
+    return retVal;
+}
+
+//------------------------------------------------------------------------------
+// solver
+
+bool evaluate_run(evaluator_program_t *program, intmax_t *result){
+    CHECK_NULL_ARGUMENT(program);
+
+    return evaluate_run_context(program, program->evaluator->context, result);
+}
+
+static bool _resolve_args(evaluator_t *this, evaluator_context_t *context, evaluator_value_t *args, unsigned argc){
+    for(unsigned j = 0; j < argc; j++){
+        if(!args[j].is_num){
+            intmax_t value = 0;
+
+            if(!_evaluator_convert(this, context, &(args[j]), &value)){
+                return false;
+            }
+
+            args[j].is_num = true;
+            args[j].payload.number = value;
         }
+    }
 
-        retVal = true;
+    return true;
+}
+
+static bool _call(evaluator_program_t *program, evaluator_context_t *context, evaluator_instruction_t *instruction, evaluator_value_t *args, intmax_t *result){
+    evaluator_t *this = program->evaluator;
+    unsigned argc = instruction->payload.call.arg_count;
+    bool func_ok = false;
+
+    if(instruction->payload.call.compute_args_fun != NULL){
+        evaluator_args_t slice = {.values = args, .count = argc, .context = context};
+        return (*(instruction->payload.call.compute_args_fun))(this, result, slice);
     }
 
-_end:
+    //compatibility with callbacks taking list_t of arguments, they have no
+    //access to context, so arguments are resolved here
+    if(!_resolve_args(this, context, args, argc)){
+        return false;
+    }
 
-    while(queue_count(to_free) > 0){
-        void *tmp = NULL;
-        queue_windraw(to_free, &tmp);
-        dynmem_free(tmp);
+    for(unsigned j = 0; j < argc; j++){
+        evaluator_value_t *arg = &(args[j]);
+        list_append(program->args, (void *)&arg);
     }
 
-    queue_destroy(to_free);
-    stack_destroy(stack);
+    func_ok = (*(instruction->payload.call.compute_fun))(this, result, program->args);
 
-    return retVal;
+    while(list_count(program->args) > 0){
+        evaluator_value_t *arg = NULL;
+        list_pop(program->args, (void *)&arg);
+    }
+
+    return func_ok;
+}
+
+static evaluator_memo_entry_t *_memo_entry(evaluator_program_t *program, evaluator_instruction_t *instruction, evaluator_value_t *args){
+    uint32_t hash = 2166136261u;
+
+    for(unsigned j = 0; j < instruction->payload.call.arg_count; j++){
+        hash ^= (uint32_t)args[j].payload.number;
+        hash *= 16777619u;
+    }
+
+    return &(program->memo[hash & (EVALUATOR_MEMO_SIZE - 1)]);
+}
+
+static bool _memo_match(evaluator_program_t *program, evaluator_memo_entry_t *entry, evaluator_instruction_t *instruction, evaluator_value_t *args){
+    if(entry->generation != program->memo_generation)
+        return false;
+
+    if(entry->compute_fun != instruction->payload.call.compute_fun || entry->compute_args_fun != instruction->payload.call.compute_args_fun)
+        return false;
+
+    if(entry->arg_count != instruction->payload.call.arg_count)
+        return false;
+
+    for(unsigned j = 0; j < entry->arg_count; j++){
+        if(entry->args[j] != args[j].payload.number)
+            return false;
+    }
+
+    return true;
+}
+
+static void _memo_store(evaluator_program_t *program, evaluator_memo_entry_t *entry, evaluator_instruction_t *instruction, evaluator_value_t *args, intmax_t result){
+    entry->generation = program->memo_generation;
+    entry->compute_fun = instruction->payload.call.compute_fun;
+    entry->compute_args_fun = instruction->payload.call.compute_args_fun;
+    entry->arg_count = instruction->payload.call.arg_count;
+    entry->result = result;
+
+    for(unsigned j = 0; j < entry->arg_count; j++){
+        entry->args[j] = args[j].payload.number;
+    }
+}
+
+bool evaluate_run_context(evaluator_program_t *program, evaluator_context_t *context, intmax_t *result){
+    CHECK_NULL_ARGUMENT(program);
+    CHECK_NULL_ARGUMENT(context);
+    CHECK_NULL_ARGUMENT(result);
+
+    evaluator_t *this = program->evaluator;
+    evaluator_value_t *stack = program->stack;
+    unsigned top = 0;
+
+    //results cached by previous run are invalidated, variables can change
+    if(program->memo != NULL){
+        program->memo_generation++;
+
+        if(program->memo_generation == 0){
+            for(unsigned i = 0; i < EVALUATOR_MEMO_SIZE; i++){
+                program->memo[i].generation = 0;
+            }
+
+            program->memo_generation = 1;
+        }
+    }
+
+    for(unsigned i = 0; i < program->code_length; i++){
+        evaluator_instruction_t *instruction = &(program->code[i]);
+
+        switch(instruction->type){
+            case INSTRUCTION_NUMBER:
+                stack[top].is_num = true;
+                stack[top].payload.number = instruction->payload.number;
+                top++;
+                break;
+
+            case INSTRUCTION_VARIABLE:
+                stack[top].is_num = false;
+                stack[top].payload.text = instruction->payload.variable.name;
+
+                //IDs are valid only in context program was compiled with
+                if(program->symbol_names != NULL && program->symbol_names == context->symbol_names){
+                    stack[top].symbol = instruction->payload.variable.symbol;
+                }
+                else{
+                    stack[top].symbol = EVALUATOR_NO_SYMBOL;
+                }
+
+                top++;
+                break;
+
+            case INSTRUCTION_CALL:{
+                intmax_t op_result = 0;
+
+                //arguments are top of the stack in order they were pushed
+                top -= instruction->payload.call.arg_count;
+
+                if(instruction->payload.call.memoize){
+                    if(!_resolve_args(this, context, &(stack[top]), instruction->payload.call.arg_count)){
+                        return false;
+                    }
+
+                    evaluator_memo_entry_t *entry = _memo_entry(program, instruction, &(stack[top]));
+
+                    if(_memo_match(program, entry, instruction, &(stack[top]))){
+                        op_result = entry->result;
+                    }
+                    else{
+                        if(!_call(program, context, instruction, &(stack[top]), &op_result)){
+                            return false;
+                        }
+
+                        _memo_store(program, entry, instruction, &(stack[top]), op_result);
+                    }
+                }
+                else if(!_call(program, context, instruction, &(stack[top]), &op_result)){
+                    return false;
+                }
+
+                stack[top].is_num = true;
+                stack[top].payload.number = op_result;
+                top++;
+                break;
+            }
+        }
+    }
+
+    if(!_evaluator_convert(this, context, &(stack[0]), result)){
+        error_buffer_write(context->error_buffer, "Can't get result from stack! This mean syntax error in expresion!");
+        return false;
+    }
+
+    return true;
 }
 
 //------------------------------------------------------------------------------
 // basic math
 
-static bool evaluate_basic_math_add(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_add(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
     intmax_t b = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
-    if(!evaluator_convert(this, args, 1, &b)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 1, &b)) return false;
     *result = a + b;
     return true;
 }
 
-static bool evaluate_basic_math_sub(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_sub(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
     intmax_t b = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
-    if(!evaluator_convert(this, args, 1, &b)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 1, &b)) return false;
     *result = a - b;
     return true;
 }
 
-static bool evaluate_basic_math_mul(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_mul(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
     intmax_t b = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
-    if(!evaluator_convert(this, args, 1, &b)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 1, &b)) return false;
     *result = a * b;
     return true;
 }
 
-static bool evaluate_basic_math_div(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_div(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
     intmax_t b = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
-    if(!evaluator_convert(this, args, 1, &b)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 1, &b)) return false;
     *result = a / b;
     return true;
 }
 
-static bool evaluate_basic_math_pow(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_pow(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
     intmax_t b = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
-    if(!evaluator_convert(this, args, 1, &b)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 1, &b)) return false;
     *result = (intmax_t)pow(a, b);
     return true;
 }
 
-static bool evaluate_basic_math_log(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_log(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
     *result = (intmax_t)log10(a);
     return true;
 }
 
-static bool evaluate_basic_math_log2(evaluator_t *this, intmax_t *result, list_t *args){
+static bool evaluate_basic_math_log2(evaluator_t *this, intmax_t *result, evaluator_args_t args){
     intmax_t a = 0;
-    if(!evaluator_convert(this, args, 0, &a)) return false;
+    if(!evaluator_convert_arg(this, args, 0, &a)) return false;
     *result = (intmax_t)log2(a);
     return true;
 }
@@ -669,11 +1466,19 @@ static bool evaluate_basic_math_log2(evaluator_t *this, intmax_t *result, list_t
 void evaluate_load_basic_math(evaluator_t *this){
     CHECK_NULL_ARGUMENT(this);
 
-    evaluate_append_operator(this, '+', 10, left, 2, &evaluate_basic_math_add);
-    evaluate_append_operator(this, '-', 10, left, 2, &evaluate_basic_math_sub);
-    evaluate_append_operator(this, '*', 20, left, 2, &evaluate_basic_math_mul);
-    evaluate_append_operator(this, '/', 20, left, 2, &evaluate_basic_math_div);
-    evaluate_append_operator(this, '^', 30, right, 2, &evaluate_basic_math_pow);
-    evaluate_append_function(this, "log10", 1, &evaluate_basic_math_log);
-    evaluate_append_function(this, "log2", 1, &evaluate_basic_math_log2);
+    evaluate_append_operator_args(this, '+', 10, left, 2, &evaluate_basic_math_add);
+    evaluate_append_operator_args(this, '-', 10, left, 2, &evaluate_basic_math_sub);
+    evaluate_append_operator_args(this, '*', 20, left, 2, &evaluate_basic_math_mul);
+    evaluate_append_operator_args(this, '/', 20, left, 2, &evaluate_basic_math_div);
+    evaluate_append_operator_args(this, '^', 30, right, 2, &evaluate_basic_math_pow);
+    evaluate_append_function_args(this, "log10", 1, &evaluate_basic_math_log);
+    evaluate_append_function_args(this, "log2", 1, &evaluate_basic_math_log2);
+
+    evaluate_set_operator_pure(this, '+');
+    evaluate_set_operator_pure(this, '-');
+    evaluate_set_operator_pure(this, '*');
+    evaluate_set_operator_pure(this, '/');
+    evaluate_set_operator_pure(this, '^');
+    evaluate_set_function_pure(this, "log10");
+    evaluate_set_function_pure(this, "log2");
 }
@@ -13,6 +13,20 @@
  * This module is also capable to deal with variables by registering one optional
  * callback. Please see evaluate_register_variable_callback().
  *
+ * Everything that change during evaluation (scratch memory, error messages,
+ * variable resolving) is kept in evaluator_context_t. Functions without
+ * context use context owned by evaluator. Functions with _context suffix
+ * only read evaluator, so one configured evaluator can be shared by many
+ * threads, when each thread use its own context. Evaluator must not be
+ * configured while it is used this way.
+ *
+ * Only functions with _context suffix (and evaluator_convert_arg()) are
+ * reentrant. Functions without context, like evaluate_expression(),
+ * evaluate_error() or evaluator_convert(), share the one context owned by
+ * evaluator together with callback registered by
+ * evaluate_register_variable_callback(). Such evaluator can't be used from
+ * more threads at once.
+ *
  * Very simple example of ussage follows.
  *
  * @code{.c}
@@ -47,6 +61,7 @@
 #include <utillib/core.h>
 
 #include "error_buffer.h"
+#include "string_cache.h"
 
 /**
  * @brief Associativity for mathematical operations.
@@ -56,17 +71,63 @@ typedef enum {
     right
 } evaluator_op_associativity_t;
 
+/**
+ * @brief Count of entries in operator table, operators are single chars.
+ */
+#define EVALUATOR_OP_TABLE_SIZE 256
+
+struct evaluator_op_record_s;
+
+/**
+ * @brief State of evaluation.
+ */
+typedef struct {
+    error_buffer_t *error_buffer;   /**< @brief Where error messages are written. */
+    bool error_buffer_allocated;    /**< @brief Error buffer is owned by context. */
+    dynmem_arena_t *arena;          /**< @brief Scratch memory released after each expression. */
+    void *user_data;                /**< @brief Pointer given to variable callback. */
+    bool (*variable_resolve_callback)(void *user_data, char *variable_name, intmax_t *value);
+    struct evaluator_symbol_names_s *symbol_names;  /**< @brief Interned names of variables or NULL if cache is disabled. */
+    struct evaluator_symbol_s *symbol_cache;        /**< @brief Resolved variables indexed by ID of interned name. */
+    unsigned symbol_cache_size;     /**< @brief Count of entries in symbol cache. */
+    unsigned symbol_generation;     /**< @brief Cached values of older generation are not valid. */
+    size_t symbol_cache_hits;       /**< @brief Count of variables found in cache. */
+    size_t symbol_cache_misses;     /**< @brief Count of variables that had to be resolved by callback. */
+} evaluator_context_t;
+
 /**
  * @brief Evaluator object.
  */
 typedef struct {
-    error_buffer_t *error_buffer;
     list_t *op_records;
     list_t *func_records;
-    bool (*variable_resolve_callback)(char *variable_name, intmax_t *value);
-    bool error_buffer_allocated;
+    struct evaluator_op_record_s *op_table[EVALUATOR_OP_TABLE_SIZE];  /**< @brief Operator records indexed by operator char. */
+    hashmap_t *func_map;    /**< @brief Function records by name (string_view_t). */
+    bool (*variable_resolve_callback)(char *variable_name, intmax_t *value);    /**< @brief Callback of functions without context, not reentrant. */
+    evaluator_context_t *context;   /**< @brief Context used by functions without explicit context, not reentrant. */
 } evaluator_t;
 
+/**
+ * @brief Compiled expression, see evaluate_compile().
+ */
+typedef struct evaluator_program_s evaluator_program_t;
+
+/**
+ * @brief Argument of math computing function, see evaluator_convert_arg().
+ */
+typedef struct evaluator_value_s evaluator_value_t;
+
+/**
+ * @brief Arguments given to math computing function.
+ *
+ * Arguments are slice of evaluation stack, so no memory is allocated for them.
+ */
+typedef struct {
+    evaluator_value_t *values;  /**< @brief First argument. */
+    unsigned count;             /**< @brief Count of arguments. */
+    evaluator_context_t *context;   /**< @brief Context of running evaluation. */
+} evaluator_args_t;
+
 /**
  * @brief Create new evaluator object.
  *
@@ -91,6 +152,111 @@ void evaluate_destroy(evaluator_t *evaluator);
  */
 void evaluate_error_buffer_set(evaluator_t *evaluator, error_buffer_t *error_buffer);
 
+/**
+ * @brief Create new evaluation context.
+ *
+ * Context has own error buffer and scratch memory and no variable callback.
+ *
+ * @param context Pointer to pointer to NULL where new object will be stored.
+ */
+void evaluate_context_new(evaluator_context_t **context);
+
+/**
+ * @brief Destroy evaluation context.
+ *
+ * @param context Pointer to object.
+ */
+void evaluate_context_destroy(evaluator_context_t *context);
+
+/**
+ * @brief Set new error buffer to existing context.
+ *
+ * @param context Pointer to context object.
+ * @param error_buffer Pointer to new error buffer object.
+ *
+ * @note This function will free only error buffer that was allocated by context itself.
+ */
+void evaluate_context_error_buffer_set(evaluator_context_t *context, error_buffer_t *error_buffer);
+
+/**
+ * @brief Register callback function to resolve variable values in context.
+ *
+ * @param context Context to register.
+ * @param variable_resolve_callback Function that will for given string name
+ * find actual value of variable and return it.
+ * @param user_data Pointer given to callback, e.g. symbol table.
+ *
+ * @note Same rules as for evaluate_register_variable_callback() applies.
+ * Values cached from previous callback are invalidated.
+ */
+void evaluate_context_register_variable_callback(
+    evaluator_context_t *context,
+    bool (*variable_resolve_callback)(void *user_data, char *variable_name, intmax_t *value),
+    void *user_data
+);
+
+/**
+ * @brief Enable caching of resolved variables in context.
+ *
+ * Variable callback is then called only for names that aren't cached yet or
+ * were invalidated. Cache is kept until it is disabled or context destroyed.
+ * Names of variables are interned when program is compiled with context, so
+ * running it with the same context finds cached values by ID without hashing.
+ *
+ * @param context Pointer to context object.
+ */
+void evaluate_context_symbol_cache_enable(evaluator_context_t *context);
+
+/**
+ * @brief Disable caching of resolved variables and drop cached values.
+ *
+ * @param context Pointer to context object.
+ */
+void evaluate_context_symbol_cache_disable(evaluator_context_t *context);
+
+/**
+ * @brief Drop cached value of one variable.
+ *
+ * @param context Pointer to context object.
+ * @param variable_name Name of variable.
+ */
+void evaluate_context_invalidate_symbol(evaluator_context_t *context, char *variable_name);
+
+/**
+ * @brief Drop cached values of all variables.
+ *
+ * Cheap, it only start new generation of cache, e.g. for each pass over input.
+ *
+ * @param context Pointer to context object.
+ */
+void evaluate_context_invalidate_symbols(evaluator_context_t *context);
+
+/**
+ * @brief Get counters of symbol cache.
+ *
+ * @param context Pointer to context object.
+ * @param hits Where to store count of variables found in cache, can be NULL.
+ * @param misses Where to store count of variables resolved by callback, can be NULL.
+ */
+void evaluate_context_symbol_cache_stats(evaluator_context_t *context, size_t *hits, size_t *misses);
+
+/**
+ * @brief Give error msg of context.
+ *
+ * @param context Pointer to context object.
+ * @return char* Error message.
+ */
+char *evaluate_context_error(evaluator_context_t *context);
+
+/**
+ * @brief Clear error message of context.
+ *
+ * Buffer set by evaluate_context_error_buffer_set() is emptied too.
+ *
+ * @param context Pointer to context object.
+ */
+void evaluate_context_clear_error(evaluator_context_t *context);
+
 /**
  * @brief Append function into math engine.
  *
@@ -106,6 +272,24 @@ void evaluate_append_function(
     bool (*compute_function)(evaluator_t *this, intmax_t *result, list_t *args)
 );
 
+/**
+ * @brief Append function that takes arguments as slice into math engine.
+ *
+ * Prefer this over evaluate_append_function(), arguments are passed without
+ * building list for each call.
+ *
+ * @param this Pointer to evaluator instance.
+ * @param func_name Name of function as will be written in expresion.
+ * @param argc Count of arguments that function need.
+ * @param compute_function Call back to resolve function, see evaluator_convert_arg().
+ */
+void evaluate_append_function_args(
+    evaluator_t *this,
+    char *func_name,
+    unsigned argc,
+    bool (*compute_function)(evaluator_t *this, intmax_t *result, evaluator_args_t args)
+);
+
 /**
  * @brief Append operator into math engine.
  *
@@ -128,6 +312,49 @@ void evaluate_append_operator(
     bool (*compute_function)(evaluator_t *this, intmax_t *result, list_t *args)
 );
 
+/**
+ * @brief Append operator that takes arguments as slice into math engine.
+ *
+ * @param this Pointer to evaluator instance.
+ * @param op Character as will be written in expresion.
+ * @param precedence Operator precedence.
+ * @param associativity Operator associativity.
+ * @param argc Count of arguments that function need.
+ * @param compute_function Call back to resolve function, see evaluator_convert_arg().
+ */
+void evaluate_append_operator_args(
+    evaluator_t *this,
+    char op,
+    int precedence,
+    evaluator_op_associativity_t associativity,
+    unsigned argc,
+    bool (*compute_function)(evaluator_t *this, intmax_t *result, evaluator_args_t args)
+);
+
+/**
+ * @brief Mark function as pure.
+ *
+ * Result of pure function depends only on its arguments and it has no side
+ * effects. Pure function with constant arguments is computed once when
+ * expression is compiled, and its results are cached while program runs, so
+ * same call with same arguments is computed only once per run.
+ *
+ * @param this Pointer to evaluator instance.
+ * @param func_name Name of already appended function.
+ */
+void evaluate_set_function_pure(evaluator_t *this, char *func_name);
+
+/**
+ * @brief Mark operator as pure.
+ *
+ * Operator with constant operands is computed once when expression is
+ * compiled, see evaluate_set_function_pure().
+ *
+ * @param this Pointer to evaluator instance.
+ * @param op Character of already appended operator.
+ */
+void evaluate_set_operator_pure(evaluator_t *this, char op);
+
 /**
  * @brief Function to convert arguments to real numbers.
  *
@@ -148,9 +375,27 @@ void evaluate_append_operator(
  * @note If evaluator have registered variable resolving callback function
  * (see void evaluate_register_variable_callback()) then this method also try
  * resolve arguments as variables.
+ *
+ * @note It use context owned by evaluator, so it is not reentrant. Functions
+ * running in other context should use evaluator_convert_arg().
  */
 bool evaluator_convert(evaluator_t *this, list_t *args, unsigned int arg_pos, intmax_t *output);
 
+/**
+ * @brief Convert argument given as slice to real number.
+ *
+ * Same as evaluator_convert(), but for functions registered by
+ * evaluate_append_function_args() and evaluate_append_operator_args().
+ *
+ * @param this Pointer to evaluator instance.
+ * @param args Arguments given to math computing function.
+ * @param arg_pos Position of argument that you want resolve.
+ * @param output Where to store result.
+ * @return true If everything was OK.
+ * @return false When for example variable cann't be resolved.
+ */
+bool evaluator_convert_arg(evaluator_t *this, evaluator_args_t args, unsigned int arg_pos, intmax_t *output);
+
 /**
  * @brief Solve mathematical expression with given evaluator.
  *
@@ -164,6 +409,104 @@ bool evaluator_convert(evaluator_t *this, list_t *args, unsigned int arg_pos, in
  */
 bool evaluate_expression(evaluator_t *this, char *expresion, intmax_t *result);
 
+/**
+ * @brief Solve mathematical expression using given context.
+ *
+ * @param this Evaluator to be used, it is only read.
+ * @param context Context for this evaluation.
+ * @param expresion Expresion to be solved.
+ * @param result Where to store result.
+ * @return true If everything was OK.
+ * @return false If error occurred, see evaluate_context_error().
+ */
+bool evaluate_expression_context(evaluator_t *this, evaluator_context_t *context, char *expresion, intmax_t *result);
+
+/**
+ * @brief Solve many expressions at once.
+ *
+ * Each variable is resolved by registered callback only once for whole batch,
+ * so callback have to give same value for same name during the batch. When
+ * symbol cache is not enabled, it is enabled just for the batch, see
+ * evaluate_symbol_cache_enable().
+ * Failing expressions don't stop the batch, their messages are appended to
+ * error buffer and their flag in ok is false.
+ *
+ * @param this Evaluator to be used.
+ * @param exprs Expressions to be solved.
+ * @param n Count of expressions.
+ * @param results Where to store results, have space for n values.
+ * @param ok Where to store success of each expression, have space for n
+ * values. Can be NULL.
+ * @return true If all expressions were solved.
+ * @return false If at least one expression failed.
+ */
+bool evaluate_expression_batch(evaluator_t *this, char **exprs, size_t n, intmax_t *results, bool *ok);
+
+/**
+ * @brief Solve many expressions at once using given context.
+ *
+ * @see evaluate_expression_batch()
+ */
+bool evaluate_expression_batch_context(evaluator_t *this, evaluator_context_t *context, char **exprs, size_t n, intmax_t *results, bool *ok);
+
+/**
+ * @brief Compile expression into program that can be run many times.
+ *
+ * Expression is tokenized, sorted to RPN and all numbers, operators and
+ * functions are resolved only once here. Variables are resolved each time
+ * program is run.
+ *
+ * @param this Evaluator to be used, it have to exist as long as program.
+ * @param expresion Expresion to be compiled.
+ * @param program Pointer to pointer to NULL where program will be stored.
+ * @return true If expression was compiled.
+ * @return false If syntax error occurred, see evaluate_error().
+ *
+ * @note Operators and functions appended to evaluator after compilation are
+ * not visible to program.
+ */
+bool evaluate_compile(evaluator_t *this, char *expresion, evaluator_program_t **program);
+
+/**
+ * @brief Compile expression using given context.
+ *
+ * @see evaluate_compile()
+ */
+bool evaluate_compile_context(evaluator_t *this, evaluator_context_t *context, char *expresion, evaluator_program_t **program);
+
+/**
+ * @brief Run compiled program.
+ *
+ * Run doesn't allocate any memory, except of error messages.
+ *
+ * @param program Program created by evaluate_compile().
+ * @param result Where to store result.
+ * @return true If everything was OK.
+ * @return false If computing function or variable resolving failed.
+ */
+bool evaluate_run(evaluator_program_t *program, intmax_t *result);
+
+/**
+ * @brief Run compiled program using given context.
+ *
+ * @note Program holds its own value stack, so one program can't be run by
+ * more threads at once. Compile program for each thread instead.
+ *
+ * @param program Program created by evaluate_compile().
+ * @param context Context used to resolve variables and report errors.
+ * @param result Where to store result.
+ * @return true If everything was OK.
+ * @return false If computing function or variable resolving failed.
+ */
+bool evaluate_run_context(evaluator_program_t *program, evaluator_context_t *context, intmax_t *result);
+
+/**
+ * @brief Destroy compiled program.
+ *
+ * @param program Program created by evaluate_compile().
+ */
+void evaluate_program_destroy(evaluator_program_t *program);
+
 /**
  * @brief Solve mathematical expression with given evaluator.
  *
@@ -199,6 +542,8 @@ void evaluate_clear_error(evaluator_t *this);
  * A + B; A - B; A * B; A / B; A^n
  * log10(x), log2(x)
  *
+ * All of them are pure, see evaluate_set_function_pure().
+ *
  * @param this Pointer to evaluator object.
  */
 void evaluate_load_basic_math(evaluator_t *this);
@@ -221,6 +566,41 @@ void evaluate_register_variable_callback(
     bool (*variable_resolve_callback)(char *variable_name, intmax_t *value)
 );
 
+/**
+ * @brief Enable caching of resolved variables in evaluator context.
+ *
+ * @see evaluate_context_symbol_cache_enable()
+ */
+void evaluate_symbol_cache_enable(evaluator_t *this);
+
+/**
+ * @brief Disable caching of resolved variables in evaluator context.
+ *
+ * @see evaluate_context_symbol_cache_disable()
+ */
+void evaluate_symbol_cache_disable(evaluator_t *this);
+
+/**
+ * @brief Drop cached value of one variable in evaluator context.
+ *
+ * @see evaluate_context_invalidate_symbol()
+ */
+void evaluate_invalidate_symbol(evaluator_t *this, char *variable_name);
+
+/**
+ * @brief Drop cached values of all variables in evaluator context.
+ *
+ * @see evaluate_context_invalidate_symbols()
+ */
+void evaluate_invalidate_symbols(evaluator_t *this);
+
+/**
+ * @brief Get counters of symbol cache in evaluator context.
+ *
+ * @see evaluate_context_symbol_cache_stats()
+ */
+void evaluate_symbol_cache_stats(evaluator_t *this, size_t *hits, size_t *misses);
+
 #endif
 
 /**
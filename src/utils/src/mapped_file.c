@@ -0,0 +1,152 @@
+#if defined(__unix__) || defined(__APPLE__)
+    #ifndef _POSIX_C_SOURCE
+        #define _POSIX_C_SOURCE 200112L
+    #endif
+    #define MAPPED_FILE_USE_MMAP
+#endif
+
+#include "mapped_file.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef MAPPED_FILE_USE_MMAP
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif
+
+#include <utillib/core.h>
+
+#define MAPPED_FILE_READ_CHUNK_SIZE 65536
+
+static bool _map(mapped_file_t *file);
+static bool _read(mapped_file_t *file);
+
+// -------------------------------------
+// Implementation of core functionality
+
+static bool _map(mapped_file_t *file){
+#ifdef MAPPED_FILE_USE_MMAP
+    int fd = open(file->filename, O_RDONLY);
+
+    if(fd < 0)
+        return false;
+
+    struct stat info;
+
+    //empty files can't be mapped, others like pipes have no size
+    if(fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0){
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    //mapping stay valid after descriptor is closed
+    close(fd);
+
+    if(data == MAP_FAILED)
+        return false;
+
+    posix_madvise(data, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+
+    file->data = (const char *)data;
+    file->length = (size_t)info.st_size;
+    file->mapped = true;
+
+    return true;
+#else
+    (void)file;
+    return false;
+#endif
+}
+
+static bool _read(mapped_file_t *file){
+    FILE *fp = fopen(file->filename, "rb");
+
+    if(fp == NULL)
+        return false;
+
+    size_t capacity = MAPPED_FILE_READ_CHUNK_SIZE;
+    size_t length = 0;
+    char *data = (char *)dynmem_malloc(capacity);
+
+    while(true){
+        if(capacity - length == 0){
+            capacity *= 2;
+            data = (char *)dynmem_realloc(data, capacity);
+        }
+
+        size_t read = fread((void *)(data + length), sizeof(char), capacity - length, fp);
+        length += read;
+
+        if(read == 0)
+            break;
+    }
+
+    bool failed = (ferror(fp) != 0);
+    fclose(fp);
+
+    if(failed){
+        dynmem_free(data);
+        return false;
+    }
+
+    file->data = data;
+    file->length = length;
+    file->mapped = false;
+
+    return true;
+}
+
+// -------------------------------------
+// Implementation of mapped files
+
+bool mapped_file_open(mapped_file_t **file, char *filename){
+    CHECK_NULL_ARGUMENT(file);
+    CHECK_NOT_NULL_ARGUMENT(*file);
+    CHECK_NULL_ARGUMENT(filename);
+
+    mapped_file_t *tmp = (mapped_file_t *)dynmem_malloc(sizeof(mapped_file_t));
+
+    tmp->data = NULL;
+    tmp->length = 0;
+    tmp->mapped = false;
+    tmp->filename = dynmem_strdup(filename);
+
+    if(!_map(tmp) && !_read(tmp)){
+        dynmem_free(tmp->filename);
+        dynmem_free(tmp);
+        return false;
+    }
+
+    *file = tmp;
+
+    return true;
+}
+
+void mapped_file_close(mapped_file_t *file){
+    CHECK_NULL_ARGUMENT(file);
+
+#ifdef MAPPED_FILE_USE_MMAP
+    if(file->mapped){
+        munmap((void *)file->data, file->length);
+    }
+    else{
+        dynmem_free((void *)file->data);
+    }
+#else
+    dynmem_free((void *)file->data);
+#endif
+
+    dynmem_free(file->filename);
+    dynmem_free(file);
+}
+
+string_view_t mapped_file_view(mapped_file_t *file){
+    CHECK_NULL_ARGUMENT(file);
+
+    return string_view_make(file->data, file->length);
+}
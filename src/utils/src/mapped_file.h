@@ -0,0 +1,76 @@
+/**
+ * @defgroup mapped_file_group Mapped file
+ *
+ * @brief Whole content of file available in memory.
+ *
+ * On POSIX systems file is mapped into memory, so nothing is copied and
+ * pages are loaded only when they are touched. When mapping is not possible
+ * (other systems, pipes, empty files) whole file is read into memory instead.
+ * Either way content is one continuous read only block, that stays valid
+ * until file is closed.
+ *
+ * @code{.c}
+ * mapped_file_t *file = NULL;
+ *
+ * if(mapped_file_open(&file, "input.asm")){
+ *     string_view_t content = mapped_file_view(file);
+ *     //work with content
+ *     mapped_file_close(file);
+ * }
+ * @endcode
+ *
+ * @ingroup utils_group
+ *
+ * @{
+ */
+
+#ifndef MAPPED_FILE_H_included
+#define MAPPED_FILE_H_included
+
+#include <stddef.h>
+#include <stdbool.h>
+
+#include <utillib/core.h>
+
+/**
+ * @brief Mapped file object.
+ */
+typedef struct{
+    const char *data;   /**< @brief Content of file, not terminated by zero. */
+    size_t length;      /**< @brief Size of content in bytes. */
+    bool mapped;        /**< @brief Content is mapped, otherwise it was read into memory. */
+    char *filename;     /**< @brief Name file was opened with. */
+}mapped_file_t;
+
+/**
+ * @brief Open file and make its content available.
+ *
+ * @param file Pointer to pointer to NULL where new object will be stored.
+ * @param filename Name of file.
+ * @return true File was opened.
+ * @return false File can't be opened or read, file pointer is untouched.
+ */
+bool mapped_file_open(mapped_file_t **file, char *filename);
+
+/**
+ * @brief Release content of file.
+ *
+ * @note Views of content are not valid after this.
+ *
+ * @param file Mapped file object.
+ */
+void mapped_file_close(mapped_file_t *file);
+
+/**
+ * @brief Get view of whole content.
+ *
+ * @param file Mapped file object.
+ * @return View valid until file is closed.
+ */
+string_view_t mapped_file_view(mapped_file_t *file);
+
+#endif
+
+/**
+ * @}
+ */
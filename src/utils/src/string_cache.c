@@ -1,20 +1,124 @@
 #include "string_cache.h"
 
+#include <stdint.h>
 #include <string.h>
 
+#define STRING_CACHE_INITIAL_SLOTS 64
+#define STRING_CACHE_INITIAL_RECORDS 32
+#define STRING_CACHE_ARENA_CHUNK_SIZE 4096
+
+//slot with id zero is empty, stored id is incremented by one
+typedef struct string_cache_slot_s{
+    uint32_t hash;
+    unsigned id;
+}string_cache_slot_t;
+
+typedef struct string_cache_record_s{
+    char *string;
+    size_t length;
+}string_cache_record_t;
+
+static unsigned _find(string_cache_t *cache, string_view_t string, uint32_t hash);
+static void _grow_slots(string_cache_t *cache);
+static unsigned _insert(string_cache_t *cache, string_view_t string, uint32_t hash, unsigned slot);
+
+// -------------------------------------
+// Implementation of core functionality
+
+static unsigned _find(string_cache_t *cache, string_view_t string, uint32_t hash){
+    unsigned mask = cache->slot_count - 1;
+    unsigned slot = hash & mask;
+
+    while(cache->slots[slot].id != 0){
+        string_cache_slot_t *head = &(cache->slots[slot]);
+
+        if(head->hash == hash){
+            string_cache_record_t *record = &(cache->records[head->id - 1]);
+
+            if(string_view_equal(string_view_make(record->string, record->length), string))
+                return slot;
+        }
+
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+static void _grow_slots(string_cache_t *cache){
+    unsigned old_count = cache->slot_count;
+    string_cache_slot_t *old_slots = cache->slots;
+
+    cache->slot_count = old_count * 2;
+    cache->slots = (string_cache_slot_t *)dynmem_calloc(cache->slot_count, sizeof(string_cache_slot_t));
+
+    //hashes are kept in slots, so strings don't have to be hashed again
+    unsigned mask = cache->slot_count - 1;
+
+    for(unsigned i = 0; i < old_count; i++){
+        if(old_slots[i].id == 0)
+            continue;
+
+        unsigned slot = old_slots[i].hash & mask;
+
+        while(cache->slots[slot].id != 0)
+            slot = (slot + 1) & mask;
+
+        cache->slots[slot] = old_slots[i];
+    }
+
+    dynmem_free(old_slots);
+}
+
+static unsigned _insert(string_cache_t *cache, string_view_t string, uint32_t hash, unsigned slot){
+    if(cache->count == cache->record_capacity){
+        cache->record_capacity *= 2;
+        cache->records = (string_cache_record_t *)dynmem_realloc(cache->records, cache->record_capacity * sizeof(string_cache_record_t));
+    }
+
+    unsigned id = cache->count++;
+
+    cache->records[id].string = string_view_arena_strdup(cache->arena, string);
+    cache->records[id].length = string.length;
+
+    cache->slots[slot].hash = hash;
+    cache->slots[slot].id = id + 1;
+
+    //keep load factor under 3/4
+    if(cache->count * 4 >= cache->slot_count * 3)
+        _grow_slots(cache);
+
+    return id;
+}
+
+// -------------------------------------
+// Implementation of string cache
+
 void string_cache_new(string_cache_t **cache){
-    list_init(cache, sizeof(char *));
+    CHECK_NULL_ARGUMENT(cache);
+    CHECK_NOT_NULL_ARGUMENT(*cache);
+
+    string_cache_t *tmp = (string_cache_t *)dynmem_malloc(sizeof(string_cache_t));
+
+    tmp->arena = NULL;
+    dynmem_arena_init(&(tmp->arena), STRING_CACHE_ARENA_CHUNK_SIZE);
+
+    tmp->slot_count = STRING_CACHE_INITIAL_SLOTS;
+    tmp->slots = (string_cache_slot_t *)dynmem_calloc(tmp->slot_count, sizeof(string_cache_slot_t));
+
+    tmp->record_capacity = STRING_CACHE_INITIAL_RECORDS;
+    tmp->records = (string_cache_record_t *)dynmem_malloc(tmp->record_capacity * sizeof(string_cache_record_t));
+    tmp->count = 0;
+
+    *cache = tmp;
 }
 
 void string_cache_destroy(string_cache_t *cache){
     if(cache != NULL){
-        while(list_count(cache) > 0){
-            char *tmp = NULL;
-            list_windraw(cache, (void *)&tmp);
-            dynmem_free(tmp);
-        }
-
-        list_destroy(cache);
+        dynmem_arena_destroy(cache->arena);
+        dynmem_free(cache->slots);
+        dynmem_free(cache->records);
+        dynmem_free(cache);
     }
 }
 
@@ -22,19 +126,51 @@ char *string_cache_process(string_cache_t *cache, char *string){
     CHECK_NULL_ARGUMENT(cache);
     CHECK_NULL_ARGUMENT(string);
 
-    for(unsigned int i = 0; i < list_count(cache); i++){
-        char *head = NULL;
-        list_at(cache, i, (void *)&head);
+    return string_cache_get(cache, string_cache_intern(cache, string_view_from(string)));
+}
 
-        if(strcmp(head, string) == 0){
-            return head;
-        }
-    }
+char *string_cache_process_view(string_cache_t *cache, string_view_t string){
+    CHECK_NULL_ARGUMENT(cache);
+
+    return string_cache_get(cache, string_cache_intern(cache, string));
+}
+
+unsigned string_cache_intern(string_cache_t *cache, string_view_t string){
+    CHECK_NULL_ARGUMENT(cache);
 
-    // If the string is not found in the cache, add it
-    char *tmp = dynmem_strdup(string);
-    list_append(cache, (void *)&tmp);
+    uint32_t hash = string_view_hash(string);
+    unsigned slot = _find(cache, string, hash);
 
-    return tmp;
+    if(cache->slots[slot].id != 0)
+        return cache->slots[slot].id - 1;
 
-}
\ No newline at end of file
+    return _insert(cache, string, hash, slot);
+}
+
+bool string_cache_find(string_cache_t *cache, string_view_t string, unsigned *id){
+    CHECK_NULL_ARGUMENT(cache);
+    CHECK_NULL_ARGUMENT(id);
+
+    unsigned slot = _find(cache, string, string_view_hash(string));
+
+    if(cache->slots[slot].id == 0)
+        return false;
+
+    *id = cache->slots[slot].id - 1;
+    return true;
+}
+
+char *string_cache_get(string_cache_t *cache, unsigned id){
+    CHECK_NULL_ARGUMENT(cache);
+
+    if(id >= cache->count)
+        error("Invalid ID of string in cache!");
+
+    return cache->records[id].string;
+}
+
+unsigned string_cache_count(string_cache_t *cache){
+    CHECK_NULL_ARGUMENT(cache);
+
+    return cache->count;
+}
@@ -3,6 +3,26 @@
  *
  * @brief Cache strings to save memory.
  *
+ * Each distinct string is stored only once (interned). Interned strings are
+ * never moved or released before cache is destroyed, so two strings
+ * processed by the same cache are equal exactly when their pointers are
+ * equal. Every interned string also gets ID, IDs are given in order from
+ * zero and can be used as index into user tables.
+ *
+ * Lookup is done by hash table, strings itself are stored in arena.
+ *
+ * @code{.c}
+ * string_cache_t *cache = NULL;
+ * string_cache_new(&cache);
+ *
+ * char *a = string_cache_process(cache, "main.c");
+ * unsigned id = string_cache_intern(cache, string_view_from("main.c"));
+ *
+ * //a == string_cache_get(cache, id)
+ *
+ * string_cache_destroy(cache);
+ * @endcode
+ *
  * @ingroup utils_group
  *
  * @{
@@ -11,9 +31,22 @@
 #ifndef STRING_CACHE_H_included
 #define STRING_CACHE_H_included
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #include <utillib/core.h>
 
-typedef list_t string_cache_t;
+/**
+ * @brief Cache object.
+ */
+typedef struct{
+    dynmem_arena_t *arena;          /**< @brief Storage of strings. */
+    struct string_cache_slot_s *slots;  /**< @brief Hash table, open addressing. */
+    unsigned slot_count;            /**< @brief Size of hash table, power of two. */
+    struct string_cache_record_s *records;  /**< @brief Interned strings indexed by ID. */
+    unsigned record_capacity;       /**< @brief Size of records array. */
+    unsigned count;                 /**< @brief Count of interned strings. */
+}string_cache_t;
 
 /**
  * @brief Create new cache object.
@@ -39,8 +72,59 @@ void string_cache_destroy(string_cache_t *cache);
  */
 char *string_cache_process(string_cache_t *cache, char *string);
 
+/**
+ * @brief Process part of string.
+ *
+ * @param cache Pointer to cache object.
+ * @param string View of string to process.
+ *
+ * @return Pointer to zero terminated interned string.
+ */
+char *string_cache_process_view(string_cache_t *cache, string_view_t string);
+
+/**
+ * @brief Intern string and get its ID.
+ *
+ * @param cache Pointer to cache object.
+ * @param string View of string to intern.
+ *
+ * @return ID of string, same string always get same ID.
+ */
+unsigned string_cache_intern(string_cache_t *cache, string_view_t string);
+
+/**
+ * @brief Find ID of string without interning it.
+ *
+ * @param cache Pointer to cache object.
+ * @param string View of string to look for.
+ * @param id Where ID is stored when string is found.
+ *
+ * @return true String is interned.
+ * @return false String is not interned, cache is untouched.
+ */
+bool string_cache_find(string_cache_t *cache, string_view_t string, unsigned *id);
+
+/**
+ * @brief Get interned string by ID.
+ *
+ * @param cache Pointer to cache object.
+ * @param id ID returned by string_cache_intern().
+ *
+ * @return Pointer to zero terminated interned string.
+ */
+char *string_cache_get(string_cache_t *cache, unsigned id);
+
+/**
+ * @brief Get count of interned strings.
+ *
+ * @param cache Pointer to cache object.
+ *
+ * @return Count of strings, all IDs are lower than this.
+ */
+unsigned string_cache_count(string_cache_t *cache);
+
 #endif
 
 /**
  * @}
- */
\ No newline at end of file
+ */
@@ -4,19 +4,33 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
 
 #include <utillib/core.h>
 
 #include "string_cache.h"
-
-#define CHUNK_SIZE_FOR_READING_FILE 1024
+#include "mapped_file.h"
 
 static string_cache_t *filename_cache = NULL;
-
-static token_t *tokenizer_token_new(char *token_data, char *filename, long line_number, long column);
+static char empty_filename[] = "";
+
+#define CLASS_SEPARATOR     0x01    //ends token
+#define CLASS_PARENTHESIS   0x02    //token on its own
+#define CLASS_STRING_MARK   0x04    //starts or ends string
+#define CLASS_COMMENT       0x08    //may start or end comment, comment methods are asked
+#define CLASS_SKIP          0x10    //ignored completely
+#define CLASS_NEWLINE       0x20    //moves to next line
+#define CLASS_TAB           0x40    //replaced by space
+#define CLASS_HOOK          0x80    //separator method is asked
+
+static token_t *tokenizer_token_new(dynmem_arena_t *arena, string_view_t text, bool copy, char *filename, long line_number, long column);
 static char *filename_store(char *filename);
 static void clean_filename_cache(void);
 static void handle_two_char_comment(tokenizer_t *this);
+static void tokenize_mapped(tokenizer_t *tokenizer, mapped_file_t *file, bool retain);
+static void source_set(tokenizer_t *tokenizer, string_view_t input, mapped_file_t *file, bool owned, bool retain);
+static void source_end(tokenizer_t *tokenizer);
+static void build_char_class(tokenizer_t *tokenizer);
 
 bool is_separator(tokenizer_t *this){
     switch(this->state.current_char){
@@ -69,35 +83,6 @@ bool is_comment_end(tokenizer_t *this){
     }
 }
 
-static bool should_skip(tokenizer_t *this){
-    switch(this->state.current_char){
-        case '\r':
-            return true;
-        default:
-            return false;
-    }
-}
-
-static void replace_if_needed(tokenizer_t *this){
-    if(this->state.current_char == '\t'){
-        this->state.current_char = ' ';
-    }
-}
-
-static bool is_parenthessis(tokenizer_t *this){
-    switch(this->state.current_char){
-        case '(':
-        case ')':
-        case '{':
-        case '}':
-        case '[':
-        case ']':
-            return true;
-        default:
-            return false;
-    }
-}
-
 static bool is_string_mark(tokenizer_t *this){
     if(this->state.current_char == '\"' && this->state.previous_char != '\\')
         return true;
@@ -107,142 +92,275 @@ static bool is_string_mark(tokenizer_t *this){
         return false;
 }
 
+static char *reserve_in_buffer(tokenizer_t *this, size_t length){
+    //array doubles its size, so appending is amortized constant, one more for terminator
+    while(this->buffer_length + length + 1 > array_get_size(this->buffer)){
+        array_enlarge(this->buffer);
+    }
+
+    return (char *)array_get_data(this->buffer) + this->buffer_length;
+}
+
+static void terminate_buffer(tokenizer_t *this){
+    //callbacks can read buffer as zero terminated string
+    ((char *)array_get_data(this->buffer))[this->buffer_length] = '\0';
+}
+
 static void append_in_buffer(tokenizer_t *this){
-    unsigned len = strlen((char *)array_get_data(this->buffer));
-    char tmp = '\0';
+    size_t len = this->buffer_length;
 
-    while(len + 2 > array_get_size(this->buffer)){
-        array_enlarge(this->buffer);
+    //track if token is still same as part of input, so it can refer to it
+    if(len == 0){
+        this->state.token_start = this->state.current_position;
+        this->state.token_contiguous = this->state.input_retained;
+    }
+    else if(this->state.token_start + len != this->state.current_position){
+        this->state.token_contiguous = false;
+    }
+
+    if(*(this->state.current_position) != this->state.current_char){
+        this->state.token_contiguous = false;
     }
 
-    array_set(this->buffer, len, (void *)&(this->state.current_char));
-    array_set(this->buffer, len + 1, (void *)&tmp);
+    *reserve_in_buffer(this, 1) = this->state.current_char;
+    this->buffer_length += 1;
+    this->state.previous_char_in_buffer = true;
+    terminate_buffer(this);
 }
 
-static void put_buffer_to_output(tokenizer_t *this){
-    char *data = NULL;
-    unsigned data_len = 0;
+static void append_run_in_buffer(tokenizer_t *this, const char *run, size_t length){
+    size_t len = this->buffer_length;
+
+    //same tracking as in append_in_buffer(), run is never modified
+    if(len == 0){
+        this->state.token_start = run;
+        this->state.token_contiguous = this->state.input_retained;
+    }
+    else if(this->state.token_start + len != run){
+        this->state.token_contiguous = false;
+    }
 
-    data = (char *)array_get_data(this->buffer);
-    data_len = strlen(data);
+    memcpy(reserve_in_buffer(this, length), run, length);
+    this->buffer_length += length;
+    this->state.previous_char_in_buffer = true;
+    terminate_buffer(this);
+}
+
+static void put_buffer_to_output(tokenizer_t *this){
+    char *data = (char *)array_get_data(this->buffer);
+    size_t data_len = this->buffer_length;
 
     if(data_len == 0)
         return;
 
-    token_t *tmp = tokenizer_token_new(data,
+    bool copy = !(this->state.token_contiguous);
+    string_view_t text = string_view_make(copy ? data : this->state.token_start, data_len);
+
+    token_t *tmp = tokenizer_token_new(this->arena,
+        text,
+        copy,
         this->state.current_filename,
         this->state.current_line_number,
-        this->state.current_column_number - data_len
+        this->state.current_column_number - (long)data_len
     );
 
     queue_append(this->output, (void *)&tmp);
 }
 
 static void cleanup_buffer(tokenizer_t *this){
-    char tmp = '\0';
+    //content is just overwritten by next token
+    this->buffer_length = 0;
+    terminate_buffer(this);
+    this->state.previous_char_in_buffer = false;
 
-    array_cleanup(this->buffer);
-    array_set(this->buffer, 0, (void *)&tmp);   //make sure there is null char
+    this->state.token_start = NULL;
+    this->state.token_contiguous = false;
 }
 
-static void tokenize_loop(tokenizer_t *tokenizer, char *input){
+static void tokenize_char(tokenizer_t *tokenizer, const char *position){
     tokenizer_t *t = tokenizer;
+    uint8_t class = t->char_class[(unsigned char)*position];
 
-    for(unsigned i = 0; input[i] != '\0'; i++){
-        t->state.current_char = input[i];
+    t->state.current_char = *position;
+    t->state.current_position = position;
 
-        replace_if_needed(t);
+    if(class & CLASS_TAB){
+        t->state.current_char = ' ';
+        class = t->char_class[(unsigned char)' '];
+    }
 
-        if(should_skip(t))
-            continue;
+    if(class & CLASS_SKIP)
+        return;
 
-        if(t->state.comment_block_active){
-            if(t->methods.is_comment_end(t)){
-                t->state.comment_block_active = false;
-            }
+    if(t->state.comment_block_active){
+        if((class & CLASS_COMMENT) && t->methods.is_comment_end(t)){
+            t->state.comment_block_active = false;
         }
-        else{
-            if(t->methods.is_comment_start(t)){
-                t->state.comment_block_active = true;
-                handle_two_char_comment(t);
-            }
-            else if(is_string_mark(t)){
-                append_in_buffer(t);
-                if(t->state.string_block_active){
-                    t->state.string_block_active = false;
-                    put_buffer_to_output(t);
-                    cleanup_buffer(t);
-                }
-                else{
-                    t->state.string_block_active = true;
-                }
+    }
+    else{
+        if((class & CLASS_COMMENT) && t->methods.is_comment_start(t)){
+            t->state.comment_block_active = true;
+            handle_two_char_comment(t);
+            t->state.previous_char_in_buffer = false;
+        }
+        else if((class & CLASS_STRING_MARK) && is_string_mark(t)){
+            append_in_buffer(t);
+            if(t->state.string_block_active){
+                t->state.string_block_active = false;
+                put_buffer_to_output(t);
+                cleanup_buffer(t);
             }
-            else if(is_parenthessis(t)){
-                if(t->state.string_block_active){
-                    append_in_buffer(t);
-                }
-                else{
-                    put_buffer_to_output(t);
-                    cleanup_buffer(t);
-
-                    append_in_buffer(t);
-
-                    put_buffer_to_output(t);
-                    cleanup_buffer(t);
-                }
+            else{
+                t->state.string_block_active = true;
             }
-            else if(t->methods.is_separator(t)){
-                if(t->state.string_block_active){
-                    append_in_buffer(t);
-                }
-                else{
-                    put_buffer_to_output(t);
-                    cleanup_buffer(t);
-                }
+        }
+        else if(class & CLASS_PARENTHESIS){
+            if(t->state.string_block_active){
+                append_in_buffer(t);
             }
             else{
+                put_buffer_to_output(t);
+                cleanup_buffer(t);
+
                 append_in_buffer(t);
+
+                put_buffer_to_output(t);
+                cleanup_buffer(t);
             }
         }
-
-        if(is_newline(t)){
-            t->state.current_line_number += 1;
-            t->state.current_column_number = 1;
+        else if((class & CLASS_SEPARATOR) || ((class & CLASS_HOOK) && t->methods.is_separator(t))){
+            if(t->state.string_block_active){
+                append_in_buffer(t);
+            }
+            else{
+                put_buffer_to_output(t);
+                cleanup_buffer(t);
+            }
         }
         else{
-            t->state.current_column_number += 1;
+            append_in_buffer(t);
         }
+    }
 
-        t->state.previous_char = t->state.current_char;
+    if(class & CLASS_NEWLINE){
+        t->state.current_line_number += 1;
+        t->state.current_column_number = 1;
+    }
+    else{
+        t->state.current_column_number += 1;
+    }
+
+    t->state.previous_char = t->state.current_char;
+}
+
+static size_t scan_ordinary(tokenizer_t *tokenizer, const char *input, size_t length){
+    const uint8_t *class = tokenizer->char_class;
+    const unsigned char *p = (const unsigned char *)input;
+    size_t i = 0;
+
+    //classes of 8 characters are joined, so block of ordinary characters cost one branch,
+    //this is not SWAR, comparing word with every special character (14 by default) was
+    //slower, newlines always end the run, so there is nothing to count inside of it
+    while(i + 8 <= length){
+        uint8_t block = class[p[i]] | class[p[i + 1]] | class[p[i + 2]] | class[p[i + 3]]
+            | class[p[i + 4]] | class[p[i + 5]] | class[p[i + 6]] | class[p[i + 7]];
+
+        if(block != 0)
+            break;
+
+        i += 8;
+    }
+
+    while(i < length && class[p[i]] == 0){
+        i++;
+    }
+
+    return i;
+}
+
+static void tokenize_run(tokenizer_t *tokenizer, const char *input, size_t length){
+    tokenizer_t *t = tokenizer;
+
+    //run is whole part of token or comment, it never contains newline
+    if(!t->state.comment_block_active)
+        append_run_in_buffer(t, input, length);
+
+    t->state.current_char = input[length - 1];
+    t->state.current_position = &(input[length - 1]);
+    t->state.current_column_number += length;
+    t->state.previous_char = t->state.current_char;
+}
+
+static size_t tokenize_step(tokenizer_t *tokenizer, const char *input, size_t length){
+    size_t run = scan_ordinary(tokenizer, input, length);
+
+    if(run == 0){
+        tokenize_char(tokenizer, input);
+        return 1;
+    }
+
+    tokenize_run(tokenizer, input, run);
+
+    return run;
+}
+
+static void tokenize_loop(tokenizer_t *tokenizer, const char *input, size_t length){
+    size_t i = 0;
+
+    while(i < length){
+        i += tokenize_step(tokenizer, &(input[i]), length - i);
     }
 }
 
 void tokenizer_init(tokenizer_t **tokenizer){
+    tokenizer_init_allocator(tokenizer, dynmem_allocator_default());
+}
+
+void tokenizer_init_allocator(tokenizer_t **tokenizer, dynmem_allocator_t *allocator){
     CHECK_NULL_ARGUMENT(tokenizer);
     CHECK_NOT_NULL_ARGUMENT(*tokenizer);
+    CHECK_NULL_ARGUMENT(allocator);
 
-    tokenizer_t *tmp = (tokenizer_t *)dynmem_malloc(sizeof(tokenizer_t));
+    tokenizer_t *tmp = (tokenizer_t *)dynmem_allocator_alloc(allocator, sizeof(tokenizer_t));
 
     tmp->state.comment_block_active = false;
     tmp->state.previous_char_was_comment_mark = false;
+    tmp->state.previous_char_in_buffer = false;
     tmp->state.string_block_active = false;
     tmp->state.current_char = '\0';
     tmp->state.previous_char = '\0';
     tmp->state.current_line_number = 1;
     tmp->state.current_column_number = 1;
-    tmp->state.current_filename = "";
+    tmp->state.current_filename = filename_store("");
+    tmp->state.input_retained = false;
+    tmp->state.current_position = NULL;
+    tmp->state.token_start = NULL;
+    tmp->state.token_contiguous = false;
+    tmp->state.clike_comments.enabled = false;
+    tmp->state.clike_comments.multiline_active = false;
 
     tmp->methods.is_comment_end = is_comment_end;
     tmp->methods.is_comment_start = is_comment_start;
     tmp->methods.is_separator = is_separator;
 
     tmp->buffer = NULL;
+    tmp->buffer_length = 0;
     tmp->output = NULL;
+    tmp->arena = NULL;
+    tmp->allocator = allocator;
+    tmp->retain_input = false;
+
+    tmp->source.data = NULL;
+    tmp->source.length = 0;
+    tmp->source.position = 0;
+    tmp->source.file = NULL;
+    tmp->source.file_owned = false;
 
-    array_init(&(tmp->buffer), sizeof(char), 32);
-    queue_init(&(tmp->output), sizeof(token_t *));
+    array_init_allocator(&(tmp->buffer), sizeof(char), 32, allocator);
+    queue_init_allocator(&(tmp->output), sizeof(token_t *), LIST_BACKEND_CHUNKED, allocator);
 
-    array_cleanup(tmp->buffer);
+    terminate_buffer(tmp);
+    build_char_class(tmp);
 
     *tokenizer = tmp;
 }
@@ -251,56 +369,168 @@ void tokenizer_end(tokenizer_t *tokenizer, queue_t **output){
     CHECK_NULL_ARGUMENT(tokenizer);
     CHECK_NULL_ARGUMENT(output);
 
+    source_end(tokenizer);
     put_buffer_to_output(tokenizer);
 
     if(*output == NULL)
         queue_copy(tokenizer->output, output);
     else
-        queue_merge(tokenizer->output, *output);
+        queue_merge(*output, tokenizer->output);
 
     queue_destroy(tokenizer->output);
     array_destroy(tokenizer->buffer);
-    dynmem_free(tokenizer);
+    dynmem_allocator_free(tokenizer->allocator, tokenizer, sizeof(tokenizer_t));
 }
 
 void tokenizer_tokenize_string(tokenizer_t *tokenizer, string_t *input){
     CHECK_NULL_ARGUMENT(tokenizer);
     CHECK_NULL_ARGUMENT(input);
 
-    tokenize_loop(tokenizer, string_get(input));
+    tokenizer->state.input_retained = tokenizer->retain_input;
+    tokenize_loop(tokenizer, string_get(input), string_length(input));
 }
 
 void tokenizer_tokenize_char_string(tokenizer_t *tokenizer, char *input){
     CHECK_NULL_ARGUMENT(tokenizer);
     CHECK_NULL_ARGUMENT(input);
 
-    tokenize_loop(tokenizer, input);
+    tokenizer->state.input_retained = tokenizer->retain_input;
+    tokenize_loop(tokenizer, input, strlen(input));
+}
+
+void tokenizer_tokenize_view(tokenizer_t *tokenizer, string_view_t input){
+    CHECK_NULL_ARGUMENT(tokenizer);
+
+    tokenizer->state.input_retained = tokenizer->retain_input;
+    tokenize_loop(tokenizer, input.data, input.length);
+}
+
+static void source_set(tokenizer_t *tokenizer, string_view_t input, mapped_file_t *file, bool owned, bool retain){
+    source_end(tokenizer);
+
+    tokenizer->source.data = input.data;
+    tokenizer->source.length = input.length;
+    tokenizer->source.position = 0;
+    tokenizer->source.file = file;
+    tokenizer->source.file_owned = owned;
+
+    if(file != NULL)
+        tokenizer->state.current_filename = filename_store(file->filename);
+
+    tokenizer->state.input_retained = retain;
+}
+
+static void source_end(tokenizer_t *tokenizer){
+    if(tokenizer->source.data == NULL && tokenizer->source.file == NULL)
+        return;
+
+    //unfinished token can't refer to input that is no longer tokenized
+    tokenizer->state.token_contiguous = false;
+
+    if(tokenizer->source.file != NULL){
+        tokenizer->state.current_filename = filename_store("");
+
+        if(tokenizer->source.file_owned)
+            mapped_file_close(tokenizer->source.file);
+    }
+
+    tokenizer->source.data = NULL;
+    tokenizer->source.length = 0;
+    tokenizer->source.position = 0;
+    tokenizer->source.file = NULL;
+    tokenizer->source.file_owned = false;
+}
+
+static void tokenize_mapped(tokenizer_t *tokenizer, mapped_file_t *file, bool retain){
+    string_view_t content = mapped_file_view(file);
+
+    //name is interned once here, tokens then only share the pointer
+    tokenizer->state.current_filename = filename_store(file->filename);
+    tokenizer->state.input_retained = retain;
+
+    //whole file is in memory, so it is tokenized in one pass
+    tokenize_loop(tokenizer, content.data, content.length);
+
+    //unfinished token can't refer to file, that may be closed before it is output
+    tokenizer->state.token_contiguous = false;
+    tokenizer->state.current_filename = filename_store("");
 }
 
 bool tokenizer_tokenize_file(tokenizer_t *tokenizer, char *filename){
     CHECK_NULL_ARGUMENT(tokenizer);
     CHECK_NULL_ARGUMENT(filename);
 
-    FILE *fp = fopen(filename, "rb");
+    mapped_file_t *file = NULL;
 
-    if(fp == NULL)
+    if(!mapped_file_open(&file, filename))
         return false;
 
-    char *tmp_buffer = dynmem_calloc(CHUNK_SIZE_FOR_READING_FILE, sizeof(char));
-    size_t read = 0;
+    tokenize_mapped(tokenizer, file, false);
+    mapped_file_close(file);
+
+    return true;
+}
+
+void tokenizer_tokenize_mapped_file(tokenizer_t *tokenizer, mapped_file_t *file){
+    CHECK_NULL_ARGUMENT(tokenizer);
+    CHECK_NULL_ARGUMENT(file);
+
+    tokenize_mapped(tokenizer, file, tokenizer->retain_input);
+}
+
+void tokenizer_begin_view(tokenizer_t *tokenizer, string_view_t input){
+    CHECK_NULL_ARGUMENT(tokenizer);
+
+    source_set(tokenizer, input, NULL, false, tokenizer->retain_input);
+}
 
-    tokenizer->state.current_filename = filename;
+bool tokenizer_begin_file(tokenizer_t *tokenizer, char *filename){
+    CHECK_NULL_ARGUMENT(tokenizer);
+    CHECK_NULL_ARGUMENT(filename);
 
-    do{
-        read = fread((void *)tmp_buffer, sizeof(char), CHUNK_SIZE_FOR_READING_FILE - 1, fp);
-        tmp_buffer[read] = '\0';
-        tokenize_loop(tokenizer, tmp_buffer);
-    }while(read > 0);
+    mapped_file_t *file = NULL;
 
-    dynmem_free(tmp_buffer);
-    fclose(fp);
+    if(!mapped_file_open(&file, filename))
+        return false;
 
-    tokenizer->state.current_filename = "";
+    //file is closed by tokenizer, so tokens can't refer to it
+    source_set(tokenizer, mapped_file_view(file), file, true, false);
+
+    return true;
+}
+
+void tokenizer_begin_mapped_file(tokenizer_t *tokenizer, mapped_file_t *file){
+    CHECK_NULL_ARGUMENT(tokenizer);
+    CHECK_NULL_ARGUMENT(file);
+
+    source_set(tokenizer, mapped_file_view(file), file, false, tokenizer->retain_input);
+}
+
+bool tokenizer_next(tokenizer_t *tokenizer, token_t **token){
+    CHECK_NULL_ARGUMENT(tokenizer);
+    CHECK_NULL_ARGUMENT(token);
+
+    tokenizer_t *t = tokenizer;
+
+    //lex only until there is something to give away
+    while(queue_count(t->output) == 0 && t->source.position < t->source.length){
+        t->source.position += tokenize_step(t,
+            &(t->source.data[t->source.position]),
+            t->source.length - t->source.position
+        );
+    }
+
+    //end of input also ends last token
+    if(queue_count(t->output) == 0 && t->source.data != NULL){
+        put_buffer_to_output(t);
+        cleanup_buffer(t);
+        source_end(t);
+    }
+
+    if(queue_count(t->output) == 0)
+        return false;
+
+    queue_windraw(t->output, (void *)token);
 
     return true;
 }
@@ -316,6 +546,8 @@ void tokenizer_config_comment(
 
     tokenizer->methods.is_comment_end = is_comment_end;
     tokenizer->methods.is_comment_start = is_comment_start;
+
+    build_char_class(tokenizer);
 }
 
 void tokenizer_config_enable_c_like_comment(
@@ -327,6 +559,24 @@ void tokenizer_config_enable_c_like_comment(
     tokenizer->state.clike_comments.enabled = true;
 }
 
+void tokenizer_config_arena(
+    tokenizer_t *tokenizer,
+    dynmem_arena_t *arena
+){
+    CHECK_NULL_ARGUMENT(tokenizer);
+    CHECK_NULL_ARGUMENT(arena);
+
+    tokenizer->arena = arena;
+}
+
+void tokenizer_config_retain_input(
+    tokenizer_t *tokenizer
+){
+    CHECK_NULL_ARGUMENT(tokenizer);
+
+    tokenizer->retain_input = true;
+}
+
 void tokenizer_config_separator(
     tokenizer_t *tokenizer,
     bool (*is_separator)(tokenizer_t *this)
@@ -335,6 +585,8 @@ void tokenizer_config_separator(
     CHECK_NULL_ARGUMENT(is_separator);
 
     tokenizer->methods.is_separator = is_separator;
+
+    build_char_class(tokenizer);
 }
 
 void tokenizer_clean_output_queue(queue_t *output){
@@ -349,15 +601,32 @@ void tokenizer_clean_output_queue(queue_t *output){
     queue_destroy(output);
 }
 
-static token_t *tokenizer_token_new(char *token_data, char *filename, long line_number, long column){
-    CHECK_NULL_ARGUMENT(token_data);
+static token_t *tokenizer_token_new(dynmem_arena_t *arena, string_view_t text, bool copy, char *filename, long line_number, long column){
     CHECK_NULL_ARGUMENT(filename);
 
-    token_t *tmp = (token_t *)dynmem_malloc(sizeof(token_t));
+    token_t *tmp = NULL;
+
+    if(arena != NULL)
+        tmp = (token_t *)dynmem_arena_malloc(arena, sizeof(token_t));
+    else
+        tmp = (token_t *)dynmem_malloc(sizeof(token_t));
+
+    if(copy){
+        if(arena != NULL)
+            tmp->token = string_view_arena_strdup(arena, text);
+        else
+            tmp->token = string_view_strdup(text);
 
-    tmp->token = dynmem_strdup(token_data);
+        tmp->text = string_view_make(tmp->token, text.length);
+    }
+    else{
+        tmp->token = NULL;
+        tmp->text = text;
+    }
+
+    tmp->arena = arena;
     tmp->column = column;
-    tmp->filename = filename_store(filename);
+    tmp->filename = filename;
     tmp->line_number = line_number;
 
     return tmp;
@@ -366,6 +635,10 @@ static token_t *tokenizer_token_new(char *token_data, char *filename, long line_
 void tokenizer_token_destroy(token_t *token){
     CHECK_NULL_ARGUMENT(token);
 
+    if(token->arena != NULL){
+        return;
+    }
+
     if(token->token != NULL){
         dynmem_free(token->token);
     }
@@ -376,6 +649,11 @@ void tokenizer_token_destroy(token_t *token){
 static char *filename_store(char *filename){
     CHECK_NULL_ARGUMENT(filename);
 
+    //tokenizers not reading files never touch shared cache
+    if(filename[0] == '\0'){
+        return empty_filename;
+    }
+
     if(filename_cache == NULL){
         string_cache_new(&filename_cache);
         atexit_register(&clean_filename_cache);
@@ -390,19 +668,55 @@ static void clean_filename_cache(void){
     }
 }
 
+static void build_char_class(tokenizer_t *tokenizer){
+    uint8_t all = 0;
+
+    //custom methods can't be described by table, so they are asked for every character
+    if(tokenizer->methods.is_comment_start != is_comment_start || tokenizer->methods.is_comment_end != is_comment_end)
+        all |= CLASS_COMMENT;
+
+    if(tokenizer->methods.is_separator != is_separator)
+        all |= CLASS_HOOK;
+
+    for(unsigned i = 0; i < 256; i++){
+        tokenizer->char_class[i] = all;
+    }
+
+    if(tokenizer->methods.is_separator == is_separator){
+        tokenizer->char_class[(unsigned char)' '] |= CLASS_SEPARATOR;
+        tokenizer->char_class[(unsigned char)'\n'] |= CLASS_SEPARATOR;
+    }
+
+    //characters default comment methods look at
+    tokenizer->char_class[(unsigned char)'/'] |= CLASS_COMMENT;
+    tokenizer->char_class[(unsigned char)'*'] |= CLASS_COMMENT;
+    tokenizer->char_class[(unsigned char)'\n'] |= CLASS_COMMENT | CLASS_NEWLINE;
+
+    tokenizer->char_class[(unsigned char)'('] |= CLASS_PARENTHESIS;
+    tokenizer->char_class[(unsigned char)')'] |= CLASS_PARENTHESIS;
+    tokenizer->char_class[(unsigned char)'{'] |= CLASS_PARENTHESIS;
+    tokenizer->char_class[(unsigned char)'}'] |= CLASS_PARENTHESIS;
+    tokenizer->char_class[(unsigned char)'['] |= CLASS_PARENTHESIS;
+    tokenizer->char_class[(unsigned char)']'] |= CLASS_PARENTHESIS;
+
+    tokenizer->char_class[(unsigned char)'\"'] |= CLASS_STRING_MARK;
+    tokenizer->char_class[(unsigned char)'\''] |= CLASS_STRING_MARK;
+
+    tokenizer->char_class[(unsigned char)'\r'] |= CLASS_SKIP;
+    tokenizer->char_class[(unsigned char)'\t'] |= CLASS_TAB;
+}
+
 static void handle_two_char_comment(tokenizer_t *this){
     CHECK_NULL_ARGUMENT(this);
 
     if(this->state.previous_char_was_comment_mark == false)
         return;
 
-    unsigned pos = 0;
-    char tmp = '\0';
-
-    while('\0' != *(char *)array_at(this->buffer, pos)){
-        pos++;
+    //first mark is in buffer, unless it ended previous comment
+    if(this->state.previous_char_in_buffer){
+        this->buffer_length -= 1;
+        terminate_buffer(this);
     }
 
-    array_set(this->buffer, pos - 1, (void *)&tmp);
     this->state.previous_char_was_comment_mark = false;
 }
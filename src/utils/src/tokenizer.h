@@ -14,27 +14,48 @@
 #define TOKENIZER_H_included
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <utillib/core.h>
 
+#include "mapped_file.h"
+
 typedef struct{
-    char *token;
+    char *token;            /**< @brief Zero terminated copy of token, NULL if token refers to input. */
+    string_view_t text;     /**< @brief Text of token, refers to token or to retained input. */
     long line_number;
     long column;
     char *filename;
+    dynmem_arena_t *arena;  /**< @brief Arena token is allocated from or NULL. */
 }token_t;
 
 typedef struct tokenizer_s{
-    array_t *buffer;
+    array_t *buffer;                /**< @brief Characters of unfinished token, zero terminated. */
+    size_t buffer_length;           /**< @brief Count of characters in buffer, without terminator. */
     queue_t *output;
+    dynmem_arena_t *arena;
+    dynmem_allocator_t *allocator;
+    bool retain_input;
+    struct{
+        const char *data;           /**< @brief Input pulled by tokenizer_next() or NULL. */
+        size_t length;
+        size_t position;            /**< @brief Offset of next character to be tokenized. */
+        mapped_file_t *file;        /**< @brief File input is part of or NULL. */
+        bool file_owned;            /**< @brief File was opened by tokenizer and is closed by it. */
+    }source;
     struct{
         bool comment_block_active;
         bool previous_char_was_comment_mark;
+        bool previous_char_in_buffer;   /**< @brief Previous character was appended and is last one in buffer. */
         bool string_block_active;
         char current_char;
         char previous_char;
         long current_line_number;
         long current_column_number;
-        char *current_filename;
+        char *current_filename;     /**< @brief Name interned in filename cache, shared by tokens. */
+        bool input_retained;
+        const char *current_position;
+        const char *token_start;
+        bool token_contiguous;
         struct{
             bool multiline_active;
             bool enabled;
@@ -45,19 +66,98 @@ typedef struct tokenizer_s{
         bool (*is_comment_end)(struct tokenizer_s *this);
         bool (*is_separator)(struct tokenizer_s *this);
     }methods;
+    uint8_t char_class[256];        /**< @brief Class of every character, built from configured methods. */
 }tokenizer_t;
 
 extern void tokenizer_init(tokenizer_t **tokenizer);
+extern void tokenizer_init_allocator(tokenizer_t **tokenizer, dynmem_allocator_t *allocator);
 
 extern void tokenizer_tokenize_string(tokenizer_t *tokenizer, string_t *input);
 extern void tokenizer_tokenize_char_string(tokenizer_t *tokenizer, char *input);
+extern void tokenizer_tokenize_view(tokenizer_t *tokenizer, string_view_t input);
 extern bool tokenizer_tokenize_file(tokenizer_t *tokenizer, char *filename);
 
 /**
- * @brief
+ * @brief Tokenize whole content of opened file in one pass.
+ *
+ * Unlike tokenizer_tokenize_file() input is retained when tokenizer is
+ * configured by tokenizer_config_retain_input(), so tokens refer directly
+ * to mapped memory. File then have to stay open as long as tokens exist.
+ *
+ * @param tokenizer Tokenizer instance.
+ * @param file File opened by mapped_file_open().
+ */
+extern void tokenizer_tokenize_mapped_file(tokenizer_t *tokenizer, mapped_file_t *file);
+
+/**
+ * @brief Set input for tokenizer_next().
+ *
+ * Nothing is tokenized until tokens are pulled. Input have to stay unchanged
+ * until it is fully pulled or another input is set.
+ *
+ * @param tokenizer Tokenizer instance.
+ * @param input Input to be tokenized.
+ */
+extern void tokenizer_begin_view(tokenizer_t *tokenizer, string_view_t input);
+
+/**
+ * @brief Open file as input for tokenizer_next().
+ *
+ * File is mapped, so only part of it that is tokenized is loaded in memory.
+ * Tokenizer closes file when it is pulled to the end. Tokens are always
+ * copied.
+ *
+ * @param tokenizer Tokenizer instance.
+ * @param filename Name of file.
+ * @return true File was opened.
+ * @return false File can't be opened.
+ */
+extern bool tokenizer_begin_file(tokenizer_t *tokenizer, char *filename);
+
+/**
+ * @brief Set opened file as input for tokenizer_next().
+ *
+ * File is not closed by tokenizer. Input is retained when tokenizer is
+ * configured so by tokenizer_config_retain_input().
+ *
+ * @param tokenizer Tokenizer instance.
+ * @param file File opened by mapped_file_open().
+ */
+extern void tokenizer_begin_mapped_file(tokenizer_t *tokenizer, mapped_file_t *file);
+
+/**
+ * @brief Pull next token.
+ *
+ * Input set by tokenizer_begin_view(), tokenizer_begin_file() or
+ * tokenizer_begin_mapped_file() is tokenized lazily, only until next token
+ * is complete, so memory used doesn't depend on size of input. Tokens left
+ * by tokenize functions are given first. End of input ends last token.
+ *
+ * @code{.c}
+ * token_t *token = NULL;
+ *
+ * tokenizer_begin_view(tokenizer, string_view_from("mov a , b"));
+ *
+ * while(tokenizer_next(tokenizer, &token)){
+ *     //work with token
+ *     tokenizer_token_destroy(token);
+ * }
+ * @endcode
+ *
+ * @param tokenizer Tokenizer instance.
+ * @param token Where next token will be stored, it is owned by caller.
+ * @return true Token was stored.
+ * @return false There are no more tokens.
+ */
+extern bool tokenizer_next(tokenizer_t *tokenizer, token_t **token);
+
+/**
+ * @brief Finish tokenizing, give away tokens and destroy tokenizer.
  *
- * @param tokenizer
+ * @param tokenizer Tokenizer instance.
  * @param output Contains an pointers to token_t structures. Each with one token.
+ * New queue is created when it points to NULL, otherwise tokens are appended
+ * after tokens already in queue.
  */
 extern void tokenizer_end(tokenizer_t *tokenizer, queue_t **output);
 
@@ -77,6 +177,37 @@ extern void tokenizer_config_comment(
     bool (*is_comment_end)(tokenizer_t *this)
 );
 
+/**
+ * @brief Allocate tokens from arena.
+ *
+ * Tokens are then released together with arena, tokenizer_token_destroy()
+ * and tokenizer_clean_output_queue() will not free them.
+ *
+ * @param tokenizer Tokenizer instance to be configured.
+ * @param arena Arena to allocate tokens from.
+ */
+extern void tokenizer_config_arena(
+    tokenizer_t *tokenizer,
+    dynmem_arena_t *arena
+);
+
+/**
+ * @brief Let tokens refer to input instead of copying it.
+ *
+ * Caller have to keep input given to tokenizer_tokenize_string(),
+ * tokenizer_tokenize_char_string() or tokenizer_tokenize_view() unchanged
+ * as long as tokens exist. Tokens that are contiguous in input then only
+ * refer to it by token->text and token->token is NULL. Tokens that had to be
+ * modified (e.g. comment inside of token) are still copied. Input of
+ * tokenizer_tokenize_file() is always copied, use
+ * tokenizer_tokenize_mapped_file() to refer to content of file.
+ *
+ * @param tokenizer Tokenizer instance to be configured.
+ */
+extern void tokenizer_config_retain_input(
+    tokenizer_t *tokenizer
+);
+
 extern void tokenizer_config_separator(
     tokenizer_t *tokenizer,
     bool (*is_separator)(tokenizer_t *this)
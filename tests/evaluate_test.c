@@ -0,0 +1,111 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <utillib/core.h>
+#include <utillib/utils.h>
+
+#include "test.h"
+
+//buffer given by caller is only emptied, evaluator keeps using it
+static void test_clear_borrowed_error_buffer(void){
+    evaluator_t *evaluator = NULL;
+    error_buffer_t *buffer = NULL;
+    intmax_t result = 0;
+
+    evaluate_new(&evaluator);
+    evaluate_load_basic_math(evaluator);
+    error_buffer_init(&buffer);
+    evaluate_error_buffer_set(evaluator, buffer);
+
+    TEST_CHECK(evaluate_expression(evaluator, "unknown_symbol", &result) == false);
+    TEST_CHECK(strlen(error_buffer_get(buffer)) != 0);
+
+    evaluate_clear_error(evaluator);
+    TEST_CHECK(strlen(error_buffer_get(buffer)) == 0);
+    TEST_CHECK(strlen(evaluate_error(evaluator)) == 0);
+
+    TEST_CHECK(evaluate_expression(evaluator, "unknown_symbol", &result) == false);
+    TEST_CHECK(strlen(error_buffer_get(buffer)) != 0);
+
+    evaluate_destroy(evaluator);
+    error_buffer_destroy(buffer);
+}
+
+static unsigned resolve_calls = 0;
+
+static bool resolve_one(void *user_data, char *variable_name, intmax_t *value){
+    (void)user_data;
+    resolve_calls++;
+    *value = (strcmp(variable_name, "x") == 0) ? 1 : 0;
+    return true;
+}
+
+static bool resolve_user_data(void *user_data, char *variable_name, intmax_t *value){
+    (void)variable_name;
+    resolve_calls++;
+    *value = *(intmax_t *)user_data;
+    return true;
+}
+
+//cached values are dropped when callback or its data are replaced
+static void test_symbol_cache_callback_replaced(void){
+    evaluator_t *evaluator = NULL;
+    evaluator_context_t *context = NULL;
+    evaluator_context_t *other = NULL;
+    evaluator_program_t *program = NULL;
+    intmax_t result = 0;
+    intmax_t data = 10;
+    size_t hits = 0;
+
+    evaluate_new(&evaluator);
+    evaluate_load_basic_math(evaluator);
+    evaluate_context_new(&context);
+    evaluate_context_symbol_cache_enable(context);
+    evaluate_context_register_variable_callback(context, resolve_one, NULL);
+
+    TEST_CHECK(evaluate_compile_context(evaluator, context, "x + x", &program));
+
+    resolve_calls = 0;
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 2);
+    TEST_CHECK(resolve_calls == 1);
+    evaluate_context_symbol_cache_stats(context, &hits, NULL);
+    TEST_CHECK(hits == 1);
+
+    //unknown name is ignored, known one is resolved again
+    evaluate_context_invalidate_symbol(context, "unknown");
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 2);
+    TEST_CHECK(resolve_calls == 1);
+    evaluate_context_invalidate_symbol(context, "x");
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 2);
+    TEST_CHECK(resolve_calls == 2);
+
+    evaluate_context_register_variable_callback(context, resolve_user_data, &data);
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 20);
+
+    data = 7;
+    evaluate_context_register_variable_callback(context, resolve_user_data, &data);
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 14);
+
+    //other context resolves names itself
+    evaluate_context_new(&other);
+    evaluate_context_symbol_cache_enable(other);
+    evaluate_context_register_variable_callback(other, resolve_one, NULL);
+    TEST_CHECK(evaluate_run_context(program, other, &result) && result == 2);
+
+    //program keeps its names alive even when cache is disabled
+    evaluate_context_symbol_cache_disable(context);
+    evaluate_context_symbol_cache_enable(context);
+    TEST_CHECK(evaluate_run_context(program, context, &result) && result == 14);
+
+    evaluate_program_destroy(program);
+    evaluate_context_destroy(other);
+    evaluate_context_destroy(context);
+    evaluate_destroy(evaluator);
+}
+
+int main(void){
+    test_clear_borrowed_error_buffer();
+    test_symbol_cache_callback_replaced();
+
+    return TEST_RESULT();
+}
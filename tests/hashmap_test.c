@@ -0,0 +1,263 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <utillib/core.h>
+
+#include "test.h"
+
+#define KEY_COUNT 512
+
+//layout of slot header, see hashmap.c
+typedef struct{
+    uint32_t hash;
+    uint32_t distance;
+}slot_header_t;
+
+static unsigned random_state = 1;
+
+static unsigned next_random(void){
+    random_state = random_state * 1103515245u + 12345u;
+    return (random_state >> 16) & 0x7fff;
+}
+
+//only four different hashes, so most keys collide
+static uint32_t colliding_hash(const void *key, size_t key_size){
+    (void)key_size;
+    return (uint32_t)(*(const int *)key % 4);
+}
+
+static uint32_t constant_hash(const void *key, size_t key_size){
+    (void)key;
+    (void)key_size;
+    return 7;
+}
+
+static slot_header_t *slot_at(hashmap_t *map, unsigned index){
+    return (slot_header_t *)((char *)map->slots + (size_t)index * map->slot_size);
+}
+
+//every key is at its distance from home slot and there are no gaps in probe sequences
+static bool robin_hood_ok(hashmap_t *map){
+    unsigned mask = map->capacity - 1;
+    unsigned count = 0;
+
+    for(unsigned i = 0; i < map->capacity; i++){
+        slot_header_t *slot = slot_at(map, i);
+        slot_header_t *next = slot_at(map, (i + 1) & mask);
+
+        if(slot->distance == 0){
+            if(next->distance > 1)
+                return false;
+            continue;
+        }
+
+        count++;
+
+        if(((i - (slot->distance - 1)) & mask) != (slot->hash & mask))
+            return false;
+
+        if(next->distance > slot->distance + 1)
+            return false;
+    }
+
+    return count == map->count;
+}
+
+static bool equals_model(hashmap_t *map, int *values, bool *present){
+    unsigned count = 0;
+
+    for(int key = 0; key < KEY_COUNT; key++){
+        int value = -1;
+        bool found = hashmap_get(map, &key, &value);
+
+        if(found != present[key])
+            return false;
+
+        if(found && value != values[key])
+            return false;
+
+        count += present[key];
+    }
+
+    return count == hashmap_count(map) && robin_hood_ok(map);
+}
+
+static void test_random_operations(hashmap_hash_t hash){
+    hashmap_t *map = NULL;
+    int values[KEY_COUNT];
+    bool present[KEY_COUNT];
+    bool same = true;
+
+    memset(present, 0, sizeof(present));
+    hashmap_init(&map, sizeof(int), sizeof(int), hash, NULL);
+    random_state = 1;
+
+    for(int i = 0; i < 20000 && same; i++){
+        int key = (int)(next_random() % KEY_COUNT);
+
+        //keys are added in first half and mostly removed in second one
+        if(next_random() % 10 < ((i < 10000) ? 7u : 3u)){
+            int value = i;
+            same = same && (hashmap_set(map, &key, &value) == !present[key]);
+            values[key] = value;
+            present[key] = true;
+        }
+        else{
+            same = same && (hashmap_remove(map, &key) == present[key]);
+            present[key] = false;
+        }
+
+        if(i % 101 == 0)
+            same = same && equals_model(map, values, present);
+    }
+
+    TEST_CHECK(same);
+    TEST_CHECK(equals_model(map, values, present));
+
+    hashmap_destroy(map);
+}
+
+//removed key is replaced by following keys of the same probe sequence
+static void test_backward_shift(void){
+    hashmap_t *map = NULL;
+    bool same = true;
+
+    hashmap_init(&map, sizeof(int), sizeof(int), constant_hash, NULL);
+
+    for(int key = 0; key < 50; key++){
+        int value = key * 10;
+        hashmap_set(map, &key, &value);
+    }
+
+    int order[] = {25, 0, 49, 24, 26};
+
+    for(unsigned i = 0; i < 5; i++){
+        TEST_CHECK(hashmap_remove(map, &(order[i])));
+        TEST_CHECK(hashmap_remove(map, &(order[i])) == false);
+        TEST_CHECK(robin_hood_ok(map));
+    }
+
+    for(int key = 0; key < 50; key++){
+        int *value = (int *)hashmap_at(map, &key);
+        bool removed = (key == 0 || key == 24 || key == 25 || key == 26 || key == 49);
+
+        same = same && ((value == NULL) == removed);
+        same = same && (removed || *value == key * 10);
+    }
+
+    TEST_CHECK(same);
+    TEST_CHECK(hashmap_count(map) == 45);
+
+    hashmap_destroy(map);
+}
+
+static void test_reserve_rehash(void){
+    hashmap_t *map = NULL;
+    bool same = true;
+
+    hashmap_init(&map, sizeof(int), sizeof(int), NULL, NULL);
+    hashmap_reserve(map, 1000);
+
+    unsigned capacity = map->capacity;
+    void *slots = map->slots;
+
+    TEST_CHECK((capacity & (capacity - 1)) == 0);
+    TEST_CHECK((size_t)capacity * 7 >= 1000 * 8);
+
+    for(int key = 0; key < 1000; key++){
+        hashmap_set(map, &key, &key);
+    }
+
+    //reserved map is not rebuilt
+    TEST_CHECK(map->capacity == capacity && map->slots == slots);
+
+    //too small capacity is enlarged to fit keys
+    hashmap_rehash(map, 16);
+    TEST_CHECK((size_t)map->capacity * 7 >= 1000 * 8);
+    TEST_CHECK(robin_hood_ok(map));
+
+    hashmap_rehash(map, 3000);
+    TEST_CHECK(map->capacity == 4096);
+    TEST_CHECK(robin_hood_ok(map));
+
+    for(int key = 0; key < 1000; key++){
+        int value = -1;
+        same = same && hashmap_get(map, &key, &value) && value == key;
+    }
+
+    TEST_CHECK(same);
+
+    //iterator visits every key once
+    unsigned long sum = 0;
+    unsigned count = 0;
+    hashmap_iter_t it;
+
+    for(hashmap_iter_begin(map, &it); hashmap_iter_valid(&it); hashmap_iter_next(&it)){
+        sum += (unsigned long)*(const int *)hashmap_iter_key(&it);
+        same = same && (*(int *)hashmap_iter_value(&it) == *(const int *)hashmap_iter_key(&it));
+        count++;
+    }
+
+    TEST_CHECK(same && count == 1000 && sum == 999 * 1000 / 2);
+
+    hashmap_clear(map);
+    TEST_CHECK(hashmap_count(map) == 0 && map->capacity == 4096);
+    hashmap_iter_begin(map, &it);
+    TEST_CHECK(!hashmap_iter_valid(&it));
+
+    hashmap_destroy(map);
+}
+
+//strings are compared by content, not by pointer, like in options_t
+static void test_cstr_keys(void){
+    hashmap_t *map = NULL;
+    char first[] = "--output";
+    char second[] = "--output";
+    char *key = first;
+    char *same_key = second;
+    char *other = "--input";
+    int value = 1;
+
+    TEST_CHECK(hashmap_hash_cstr(&key, sizeof(char *)) == hashmap_hash_cstr(&same_key, sizeof(char *)));
+    TEST_CHECK(hashmap_hash_cstr(&key, sizeof(char *)) == string_view_hash(string_view_from(first)));
+    TEST_CHECK(hashmap_equal_cstr(&key, &same_key, sizeof(char *)));
+    TEST_CHECK(!hashmap_equal_cstr(&key, &other, sizeof(char *)));
+
+    //raw bytes are hashed same way as strings
+    TEST_CHECK(hashmap_hash_bytes(first, strlen(first)) == string_view_hash(string_view_from(first)));
+
+    hashmap_init(&map, sizeof(char *), sizeof(int), hashmap_hash_cstr, hashmap_equal_cstr);
+
+    TEST_CHECK(hashmap_set(map, &key, &value));
+    value = 2;
+    TEST_CHECK(hashmap_set(map, &same_key, &value) == false);
+    TEST_CHECK(hashmap_count(map) == 1);
+    TEST_CHECK(hashmap_get(map, &key, &value) && value == 2);
+    TEST_CHECK(hashmap_contains(map, &other) == false);
+
+    hashmap_destroy(map);
+
+    //views of different lengths over one buffer
+    string_view_t view = string_view_make(first, 4);
+    string_view_t same_view = string_view_make(second, 4);
+    string_view_t longer = string_view_make(first, 5);
+
+    map = NULL;
+    hashmap_init(&map, sizeof(string_view_t), 0, hashmap_hash_view, hashmap_equal_view);
+
+    TEST_CHECK(hashmap_set(map, &view, NULL));
+    TEST_CHECK(hashmap_contains(map, &same_view));
+    TEST_CHECK(hashmap_contains(map, &longer) == false);
+
+    hashmap_destroy(map);
+}
+
+int main(void){
+    test_random_operations(NULL);
+    test_random_operations(colliding_hash);
+    test_backward_shift();
+    test_reserve_rehash();
+    test_cstr_keys();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,106 @@
+#include <utillib/core.h>
+
+#include "test.h"
+
+typedef struct{
+    int value;
+    ilist_link_t link;
+    ilist_link_t other_link;
+}item_t;
+
+static bool equals(ilist_t *list, int *expected, unsigned count){
+    unsigned i = 0;
+
+    if(ilist_count(list) != count)
+        return false;
+
+    for(ilist_link_t *head = ilist_first(list); head != NULL; head = head->next){
+        if(i >= count || ILIST_ENTRY(head, item_t, link)->value != expected[i])
+            return false;
+        i++;
+    }
+
+    //walk back has to give the same items
+    for(ilist_link_t *head = ilist_last(list); head != NULL; head = head->prev){
+        i--;
+        if(ILIST_ENTRY(head, item_t, link)->value != expected[i])
+            return false;
+    }
+
+    return i == 0;
+}
+
+static void test_link_unlink(void){
+    ilist_t list;
+    item_t items[5];
+
+    for(int i = 0; i < 5; i++){
+        items[i].value = i;
+    }
+
+    ilist_init(&list);
+    TEST_CHECK(ilist_empty(&list));
+    TEST_CHECK(ilist_first(&list) == NULL && ilist_last(&list) == NULL);
+
+    ilist_append(&list, &(items[1].link));
+    ilist_append(&list, &(items[3].link));
+    ilist_prepend(&list, &(items[0].link));
+    ilist_insert_before(&list, &(items[3].link), &(items[2].link));
+    ilist_insert_before(&list, NULL, &(items[4].link));
+
+    int all[] = {0, 1, 2, 3, 4};
+    TEST_CHECK(equals(&list, all, 5));
+    TEST_CHECK(!ilist_empty(&list));
+
+    ilist_remove(&list, &(items[2].link));
+    TEST_CHECK(items[2].link.next == NULL && items[2].link.prev == NULL);
+
+    int removed[] = {0, 1, 3, 4};
+    TEST_CHECK(equals(&list, removed, 4));
+
+    TEST_CHECK(ILIST_ENTRY(ilist_pop(&list), item_t, link) == &(items[4]));
+    TEST_CHECK(ILIST_ENTRY(ilist_windraw(&list), item_t, link) == &(items[0]));
+
+    int middle[] = {1, 3};
+    TEST_CHECK(equals(&list, middle, 2));
+
+    ilist_remove(&list, &(items[1].link));
+    ilist_remove(&list, &(items[3].link));
+    TEST_CHECK(ilist_empty(&list));
+    TEST_CHECK(ilist_first(&list) == NULL && ilist_last(&list) == NULL);
+}
+
+//structure with two links is in two lists at once
+static void test_two_lists(void){
+    ilist_t list;
+    ilist_t other;
+    item_t items[4];
+
+    ilist_init(&list);
+    ilist_init(&other);
+
+    for(int i = 0; i < 4; i++){
+        items[i].value = i;
+        ilist_append(&list, &(items[i].link));
+        ilist_prepend(&other, &(items[i].other_link));
+    }
+
+    ilist_remove(&list, &(items[1].link));
+
+    int expected[] = {0, 2, 3};
+    TEST_CHECK(equals(&list, expected, 3));
+    TEST_CHECK(ilist_count(&other) == 4);
+
+    int value = 3;
+    for(ilist_link_t *head = ilist_first(&other); head != NULL; head = head->next){
+        TEST_CHECK(ILIST_ENTRY(head, item_t, other_link)->value == value);
+        value--;
+    }
+}
+
+int main(void){
+    test_link_unlink();
+    test_two_lists();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,477 @@
+#include <stdint.h>
+#include <string.h>
+
+#include <utillib/core.h>
+
+#include "test.h"
+
+#define MODEL_SIZE 1024
+
+static unsigned random_state = 1;
+
+static unsigned next_random(void){
+    random_state = random_state * 1103515245u + 12345u;
+    return (random_state >> 16) & 0x7fff;
+}
+
+static void init_list(list_t **list, list_backend_t backend){
+    list_init_allocator(list, sizeof(int), backend, dynmem_allocator_default());
+}
+
+//chunks no longer holding items are released
+static bool chunks_fit(list_t *list){
+    return list->chunked.used == (list->chunked.offset + list->count + LIST_CHUNK_ITEMS - 1) / LIST_CHUNK_ITEMS;
+}
+
+static bool equals_model(list_t *list, int *model, unsigned count){
+    if(list_count(list) != count)
+        return false;
+
+    for(unsigned i = 0; i < count; i++){
+        int value = 0;
+        list_at(list, i, &value);
+
+        if(value != model[i])
+            return false;
+    }
+
+    return true;
+}
+
+//random operations on both ends and in middle compared with plain array
+static void test_random_operations(list_backend_t backend){
+    list_t *list = NULL;
+    int model[MODEL_SIZE];
+    unsigned count = 0;
+    bool same = true;
+
+    init_list(&list, backend);
+    random_state = 1;
+
+    for(int i = 0; i < 20000 && same; i++){
+        unsigned op = next_random() % 6;
+        int value = i;
+
+        //list grows in first half, then it shrinks
+        if(count == 0 || (count < MODEL_SIZE && op < 3 && (i < 10000 || next_random() % 3 == 0))){
+            unsigned position = 0;
+
+            switch(op){
+                case 0:
+                    list_append(list, &value);
+                    position = count;
+                    break;
+                case 1:
+                    list_insert(list, 0, &value);
+                    break;
+                default:
+                    position = next_random() % (count + 1);
+                    list_insert(list, position, &value);
+                    break;
+            }
+
+            memmove(&(model[position + 1]), &(model[position]), (count - position) * sizeof(int));
+            model[position] = value;
+            count++;
+        }
+        else{
+            unsigned position = 0;
+
+            switch(op % 3){
+                case 0:
+                    list_pop(list, &value);
+                    position = count - 1;
+                    same = same && (value == model[position]);
+                    break;
+                case 1:
+                    list_windraw(list, &value);
+                    same = same && (value == model[position]);
+                    break;
+                default:
+                    position = next_random() % count;
+                    list_remove_at(list, position);
+                    break;
+            }
+
+            memmove(&(model[position]), &(model[position + 1]), (count - position - 1) * sizeof(int));
+            count--;
+        }
+
+        if(i % 97 == 0)
+            same = same && equals_model(list, model, count);
+    }
+
+    TEST_CHECK(same);
+    TEST_CHECK(equals_model(list, model, count));
+
+    list_destroy(list);
+}
+
+//items at both sides of chunk border are moved correctly
+static void test_chunk_borders(void){
+    list_t *list = NULL;
+    int model[MODEL_SIZE];
+    unsigned count = 2 * LIST_CHUNK_ITEMS + 1;
+
+    init_list(&list, LIST_BACKEND_CHUNKED);
+
+    for(unsigned i = 0; i < count; i++){
+        model[i] = (int)i;
+        list_append(list, &(model[i]));
+    }
+
+    TEST_CHECK(list->chunked.used == 3);
+    TEST_CHECK(chunks_fit(list));
+    TEST_CHECK(equals_model(list, model, count));
+
+    //remove last item of first chunk and first of second one
+    unsigned borders[] = {LIST_CHUNK_ITEMS - 1, LIST_CHUNK_ITEMS - 1, 2 * LIST_CHUNK_ITEMS - 3};
+
+    for(unsigned i = 0; i < 3; i++){
+        list_remove_at(list, borders[i]);
+        memmove(&(model[borders[i]]), &(model[borders[i] + 1]), (count - borders[i] - 1) * sizeof(int));
+        count--;
+        TEST_CHECK(equals_model(list, model, count));
+        TEST_CHECK(chunks_fit(list));
+    }
+
+    //chunk is released together with its last item
+    while(count > LIST_CHUNK_ITEMS){
+        int value = 0;
+        list_pop(list, &value);
+        count--;
+        TEST_CHECK(value == model[count]);
+    }
+
+    TEST_CHECK(chunks_fit(list));
+
+    //chunk border is crossed again by insert in front of it
+    int value = -1;
+    list_insert(list, LIST_CHUNK_ITEMS, &value);
+    list_insert(list, LIST_CHUNK_ITEMS - 1, &value);
+    model[count] = -1;
+    count++;
+    memmove(&(model[LIST_CHUNK_ITEMS]), &(model[LIST_CHUNK_ITEMS - 1]), 2 * sizeof(int));
+    model[LIST_CHUNK_ITEMS - 1] = -1;
+    count++;
+
+    TEST_CHECK(chunks_fit(list));
+    TEST_CHECK(equals_model(list, model, count));
+
+    list_destroy(list);
+}
+
+//queue moves through directory, head of directory wraps around
+static void test_circular_directory(void){
+    queue_t *queue = NULL;
+    int next_in = 0;
+    int next_out = 0;
+    bool ordered = true;
+    bool wrapped = false;
+
+    queue_init_chunked(&queue, sizeof(int));
+
+    for(int i = 0; i < 3 * LIST_CHUNK_ITEMS; i++){
+        queue_append(queue, &next_in);
+        next_in++;
+    }
+
+    unsigned capacity = queue->chunked.capacity;
+
+    for(int i = 0; i < 40 * LIST_CHUNK_ITEMS; i++){
+        int value = 0;
+
+        queue_append(queue, &next_in);
+        next_in++;
+        queue_windraw(queue, &value);
+        ordered = ordered && (value == next_out);
+        next_out++;
+
+        if(queue->chunked.head + queue->chunked.used > queue->chunked.capacity)
+            wrapped = true;
+    }
+
+    TEST_CHECK(ordered);
+    TEST_CHECK(wrapped);
+    TEST_CHECK(queue->chunked.capacity == capacity);
+    TEST_CHECK(queue_count(queue) == 3 * LIST_CHUNK_ITEMS);
+
+    queue_destroy(queue);
+
+    //items pushed in front take chunks before head
+    list_t *list = NULL;
+    init_list(&list, LIST_BACKEND_CHUNKED);
+
+    for(int i = 0; i < 10 * LIST_CHUNK_ITEMS; i++){
+        list_insert(list, 0, &i);
+    }
+
+    ordered = true;
+
+    for(int i = 0; i < 10 * LIST_CHUNK_ITEMS; i++){
+        int value = 0;
+        list_at(list, (unsigned)i, &value);
+        ordered = ordered && (value == 10 * LIST_CHUNK_ITEMS - 1 - i);
+    }
+
+    TEST_CHECK(ordered);
+
+    list_destroy(list);
+}
+
+//copies keep backend, merge works between backends and with itself
+static void test_copy_merge(void){
+    list_t *chunked = NULL;
+    list_t *linked = NULL;
+    list_t *copy = NULL;
+    int model[MODEL_SIZE];
+    unsigned count = 0;
+
+    init_list(&chunked, LIST_BACKEND_CHUNKED);
+    init_list(&linked, LIST_BACKEND_LINKED);
+
+    for(int i = 0; i < LIST_CHUNK_ITEMS + 10; i++){
+        list_append(chunked, &i);
+        model[count++] = i;
+    }
+
+    for(int i = 0; i < 100; i++){
+        int value = 1000 + i;
+        list_append(linked, &value);
+    }
+
+    list_copy(chunked, &copy);
+    TEST_CHECK(copy->backend == LIST_BACKEND_CHUNKED);
+    TEST_CHECK(equals_model(copy, model, count));
+
+    list_merge(copy, linked);
+
+    for(int i = 0; i < 100; i++){
+        model[count++] = 1000 + i;
+    }
+
+    TEST_CHECK(equals_model(copy, model, count));
+    TEST_CHECK(list_count(linked) == 100);
+
+    //merge with itself doubles content
+    list_merge(copy, copy);
+    memcpy(&(model[count]), model, count * sizeof(int));
+    count *= 2;
+    TEST_CHECK(equals_model(copy, model, count));
+
+    list_merge(linked, chunked);
+    TEST_CHECK(list_count(linked) == 100 + LIST_CHUNK_ITEMS + 10);
+
+    int value = 0;
+    list_at(linked, 100, &value);
+    TEST_CHECK(value == 0);
+    list_pop(linked, &value);
+    TEST_CHECK(value == LIST_CHUNK_ITEMS + 9);
+
+    list_destroy(copy);
+    list_destroy(linked);
+    list_destroy(chunked);
+}
+
+typedef struct{
+    long double number;
+    char text[41];
+}record_t;
+
+//data of linked list item are in the same allocation right after item
+static void test_inline_items(void){
+    list_t *list = NULL;
+    record_t record;
+    bool same = true;
+
+    list_init(&list, sizeof(record_t));
+
+    for(int i = 0; i < 100; i++){
+        record.number = (long double)i / 4;
+        memset(record.text, 'a' + i % 26, sizeof(record.text));
+        list_append(list, &record);
+    }
+
+    for(list_item_t *item = list->first; item != NULL; item = item->next){
+        size_t offset = (size_t)((char *)item->data - (char *)item);
+
+        same = same && (offset >= sizeof(list_item_t)) && (offset < sizeof(list_item_t) + sizeof(long double) + sizeof(intmax_t));
+        same = same && ((uintptr_t)item->data % sizeof(void *) == 0);
+    }
+
+    TEST_CHECK(same);
+
+    for(int i = 99; i >= 0; i--){
+        list_pop(list, &record);
+        same = same && (record.number == (long double)i / 4) && (record.text[40] == 'a' + i % 26);
+    }
+
+    TEST_CHECK(same);
+    TEST_CHECK(list->first == NULL && list->last == NULL);
+
+    list_destroy(list);
+}
+
+//released items are reused, slabs are allocated only when pool is empty
+static void test_pool(void){
+    stack_t *stack = NULL;
+    list_pool_stats_t stats;
+    bool same = true;
+
+    stack_init(&stack, sizeof(int));
+    stack_config_pool(stack, 16);
+
+    for(int round = 0; round < 3; round++){
+        for(int i = 0; i < 100; i++){
+            stack_push(stack, &i);
+        }
+
+        for(int i = 99; i >= 0; i--){
+            int value = 0;
+            stack_pop(stack, &value);
+            same = same && (value == i);
+        }
+    }
+
+    TEST_CHECK(same);
+
+    list_pool_stats(stack, &stats);
+    TEST_CHECK(stats.requests == 300);
+    TEST_CHECK(stats.recycled == 200);
+    TEST_CHECK(stats.slabs == 7);
+    TEST_CHECK(stats.in_use == 0);
+
+    //pool is used also for items inserted in middle and copies
+    list_t *copy = NULL;
+
+    for(int i = 0; i < 10; i++){
+        stack_push(stack, &i);
+    }
+
+    int value = 42;
+    list_insert(stack, 5, &value);
+    list_remove_at(stack, 2);
+    list_copy(stack, &copy);
+
+    list_pool_stats(stack, &stats);
+    TEST_CHECK(stats.in_use == 10);
+    TEST_CHECK(stats.slabs == 7);
+
+    list_pool_stats(copy, &stats);
+    TEST_CHECK(stats.in_use == 10 && stats.slabs == 1);
+
+    list_at(copy, 4, &value);
+    TEST_CHECK(value == 42);
+
+    list_destroy(copy);
+    stack_destroy(stack);
+}
+
+static void test_iterators(list_backend_t backend){
+    list_t *list = NULL;
+    list_iter_t it;
+    int model[MODEL_SIZE];
+    unsigned count = 3 * LIST_CHUNK_ITEMS;
+    bool same = true;
+
+    init_list(&list, backend);
+
+    //empty list has no valid position
+    list_iter_begin(list, &it);
+    TEST_CHECK(!list_iter_valid(&it));
+    list_iter_end(list, &it);
+    TEST_CHECK(!list_iter_valid(&it));
+
+    for(unsigned i = 0; i < count; i++){
+        model[i] = (int)i;
+        list_append(list, &(model[i]));
+    }
+
+    unsigned i = 0;
+    for(list_iter_begin(list, &it); list_iter_valid(&it); list_iter_next(&it)){
+        int value = 0;
+        list_iter_get(&it, &value);
+        same = same && (value == model[i]) && (*(int *)list_iter_data(&it) == model[i]);
+        i++;
+    }
+
+    TEST_CHECK(same && i == count);
+
+    for(list_iter_end(list, &it); list_iter_valid(&it); list_iter_prev(&it)){
+        i--;
+        same = same && (*(int *)list_iter_data(&it) == model[i]);
+    }
+
+    TEST_CHECK(same && i == 0);
+
+    //erase odd values, put negative value in front of multiples of ten
+    for(list_iter_begin(list, &it); list_iter_valid(&it);){
+        int value = *(int *)list_iter_data(&it);
+
+        if(value % 2 == 1){
+            list_iter_erase(&it);
+            continue;
+        }
+
+        if(value % 10 == 0){
+            int negative = -value - 1;
+            list_iter_insert_before(&it, &negative);
+            same = same && (*(int *)list_iter_data(&it) == value);
+        }
+
+        list_iter_next(&it);
+    }
+
+    TEST_CHECK(same);
+
+    unsigned new_count = 0;
+    for(unsigned j = 0; j < count; j++){
+        if(j % 10 == 0)
+            model[new_count++] = -(int)j - 1;
+        if(j % 2 == 0)
+            model[new_count++] = (int)j;
+    }
+
+    TEST_CHECK(equals_model(list, model, new_count));
+
+    //inserting at invalid iterator appends
+    int last = 1000;
+    list_iter_insert_before(&it, &last);
+    TEST_CHECK(!list_iter_valid(&it));
+    model[new_count++] = last;
+    TEST_CHECK(equals_model(list, model, new_count));
+
+    list_destroy(list);
+
+    //queue is iterated from oldest item
+    queue_t *queue = NULL;
+    queue_init_allocator(&queue, sizeof(int), backend, dynmem_allocator_default());
+
+    for(int j = 0; j < 5; j++){
+        queue_append(queue, &j);
+    }
+
+    int expected = 0;
+    for(list_iter_begin(queue, &it); list_iter_valid(&it); list_iter_next(&it)){
+        same = same && (*(int *)list_iter_data(&it) == expected);
+        expected++;
+    }
+
+    TEST_CHECK(same && expected == 5);
+
+    queue_destroy(queue);
+}
+
+int main(void){
+    test_random_operations(LIST_BACKEND_LINKED);
+    test_random_operations(LIST_BACKEND_CHUNKED);
+    test_chunk_borders();
+    test_circular_directory();
+    test_copy_merge();
+    test_inline_items();
+    test_pool();
+    test_iterators(LIST_BACKEND_LINKED);
+    test_iterators(LIST_BACKEND_CHUNKED);
+
+    return TEST_RESULT();
+}
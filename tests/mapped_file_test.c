@@ -0,0 +1,205 @@
+#if defined(__unix__) || defined(__APPLE__)
+    #ifndef _POSIX_C_SOURCE
+        #define _POSIX_C_SOURCE 200112L
+    #endif
+    #define TEST_USE_FIFO
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef TEST_USE_FIFO
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/stat.h>
+    #include <sys/wait.h>
+#endif
+
+#include <utillib/core.h>
+#include <utillib/utils.h>
+
+#include "test.h"
+
+#define TEST_FILE "mapped_file_test.tmp"
+
+static void write_file(const char *content, size_t length){
+    FILE *fp = fopen(TEST_FILE, "wb");
+
+    TEST_CHECK(fp != NULL);
+
+    if(fp != NULL){
+        fwrite(content, sizeof(char), length, fp);
+        fclose(fp);
+    }
+}
+
+static void test_mapped(void){
+    mapped_file_t *file = NULL;
+    const char content[] = "mov a, b\nnop";
+
+    write_file(content, sizeof(content) - 1);
+
+    TEST_CHECK(mapped_file_open(&file, TEST_FILE));
+
+#ifdef TEST_USE_FIFO
+    TEST_CHECK(file->mapped);
+#endif
+    TEST_CHECK(file->length == sizeof(content) - 1);
+    TEST_CHECK(memcmp(file->data, content, sizeof(content) - 1) == 0);
+    TEST_CHECK(string_view_equal_cstr(mapped_file_view(file), content));
+    TEST_CHECK(strcmp(file->filename, TEST_FILE) == 0);
+
+    mapped_file_close(file);
+    remove(TEST_FILE);
+}
+
+//empty file can't be mapped, so it is read
+static void test_empty(void){
+    mapped_file_t *file = NULL;
+
+    write_file("", 0);
+
+    TEST_CHECK(mapped_file_open(&file, TEST_FILE));
+    TEST_CHECK(!file->mapped);
+    TEST_CHECK(file->length == 0);
+    TEST_CHECK(mapped_file_view(file).length == 0);
+
+    mapped_file_close(file);
+    remove(TEST_FILE);
+}
+
+static void test_missing(void){
+    mapped_file_t *file = NULL;
+
+    remove(TEST_FILE);
+
+    TEST_CHECK(!mapped_file_open(&file, TEST_FILE));
+    TEST_CHECK(file == NULL);
+}
+
+#ifdef TEST_USE_FIFO
+//pipe has no size, it is read in chunks until writer closes it
+static void test_fifo(void){
+    mapped_file_t *file = NULL;
+    size_t length = 200000;
+    bool same = true;
+
+    remove(TEST_FILE);
+    TEST_CHECK(mkfifo(TEST_FILE, 0600) == 0);
+
+    pid_t pid = fork();
+
+    if(pid == 0){
+        int fd = open(TEST_FILE, O_WRONLY);
+
+        for(size_t i = 0; i < length; i++){
+            char c = (char)('a' + i % 26);
+            if(write(fd, &c, 1) != 1)
+                _exit(1);
+        }
+
+        close(fd);
+        _exit(0);
+    }
+
+    TEST_CHECK(pid > 0);
+    TEST_CHECK(mapped_file_open(&file, TEST_FILE));
+    TEST_CHECK(!file->mapped);
+    TEST_CHECK(file->length == length);
+
+    for(size_t i = 0; i < file->length && same; i++){
+        same = (file->data[i] == (char)('a' + i % 26));
+    }
+
+    TEST_CHECK(same);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    TEST_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    mapped_file_close(file);
+    remove(TEST_FILE);
+}
+#endif
+
+//retained tokens refer into mapping, last token has no newline after it
+static void test_tokenizer_retained(void){
+    mapped_file_t *file = NULL;
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    token_t *tokens[4];
+    char *expected[] = {"first", "second", "third", "last"};
+    unsigned count = 0;
+
+    write_file("first second\n  third\nlast", 25);
+    TEST_CHECK(mapped_file_open(&file, TEST_FILE));
+
+    tokenizer_init(&tokenizer);
+    tokenizer_config_retain_input(tokenizer);
+    tokenizer_begin_mapped_file(tokenizer, file);
+
+    token_t *token = NULL;
+
+    while(count < 4 && tokenizer_next(tokenizer, &token)){
+        tokens[count++] = token;
+    }
+
+    TEST_CHECK(count == 4);
+    TEST_CHECK(!tokenizer_next(tokenizer, &token));
+
+    tokenizer_end(tokenizer, &output);
+    TEST_CHECK(queue_count(output) == 0);
+    queue_destroy(output);
+
+    //tokens stay valid after tokenizer is gone, as long as file is open
+    for(unsigned i = 0; i < count; i++){
+        TEST_CHECK(string_view_equal_cstr(tokens[i]->text, expected[i]));
+        TEST_CHECK(tokens[i]->token == NULL);
+        TEST_CHECK(tokens[i]->text.data >= file->data && tokens[i]->text.data < file->data + file->length);
+    }
+
+    TEST_CHECK(count < 4 || (tokens[2]->line_number == 2 && tokens[3]->line_number == 3));
+
+    for(unsigned i = 0; i < count; i++){
+        tokenizer_token_destroy(tokens[i]);
+    }
+
+    mapped_file_close(file);
+    remove(TEST_FILE);
+}
+
+static void test_tokenizer_empty(void){
+    mapped_file_t *file = NULL;
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    token_t *token = NULL;
+
+    write_file("", 0);
+    TEST_CHECK(mapped_file_open(&file, TEST_FILE));
+
+    tokenizer_init(&tokenizer);
+    tokenizer_config_retain_input(tokenizer);
+    tokenizer_begin_mapped_file(tokenizer, file);
+
+    TEST_CHECK(!tokenizer_next(tokenizer, &token));
+
+    tokenizer_end(tokenizer, &output);
+    TEST_CHECK(queue_count(output) == 0);
+    queue_destroy(output);
+
+    mapped_file_close(file);
+    remove(TEST_FILE);
+}
+
+int main(void){
+    test_mapped();
+    test_empty();
+    test_missing();
+#ifdef TEST_USE_FIFO
+    test_fifo();
+#endif
+    test_tokenizer_retained();
+    test_tokenizer_empty();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,34 @@
+#include <string.h>
+
+#include <utillib/core.h>
+#include <utillib/utils.h>
+
+#include "test.h"
+
+//looking for string doesn't intern it
+static void test_find_without_insert(void){
+    string_cache_t *cache = NULL;
+    unsigned id = 0;
+
+    string_cache_new(&cache);
+
+    unsigned first = string_cache_intern(cache, string_view_from("first"));
+    unsigned second = string_cache_intern(cache, string_view_from("second"));
+
+    TEST_CHECK(string_cache_find(cache, string_view_from("first"), &id) && id == first);
+    TEST_CHECK(string_cache_find(cache, string_view_from("second"), &id) && id == second);
+
+    id = 42;
+    TEST_CHECK(string_cache_find(cache, string_view_from("third"), &id) == false);
+    TEST_CHECK(id == 42);
+    TEST_CHECK(string_cache_find(cache, string_view_make("firstly", 5), &id) && id == first);
+    TEST_CHECK(string_cache_count(cache) == 2);
+
+    string_cache_destroy(cache);
+}
+
+int main(void){
+    test_find_without_insert();
+
+    return TEST_RESULT();
+}
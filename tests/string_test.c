@@ -0,0 +1,81 @@
+#include <string.h>
+
+#include <utillib/core.h>
+
+#include "test.h"
+
+//arguments of format can point into string that is formatted
+static void test_self_append(void){
+    string_t *s = NULL;
+
+    string_init_1(&s, "ab");
+    string_appendf(s, "%s", string_get(s));
+    TEST_CHECK(strcmp(string_get(s), "abab") == 0);
+    TEST_CHECK(string_length(s) == 4);
+
+    //enough times to move string from inline storage to heap
+    for(int i = 0; i < 8; i++){
+        string_appendf(s, "%s-", string_get(s));
+    }
+    TEST_CHECK(string_length(s) == 4 * 256 + 255);
+    TEST_CHECK(string_get(s)[string_length(s) - 1] == '-');
+
+    string_destroy(s);
+}
+
+static void test_self_printf(void){
+    string_t *s = NULL;
+
+    string_init_1(&s, "abc");
+    string_printf(s, "x%s", string_get(s));
+    TEST_CHECK(strcmp(string_get(s), "xabc") == 0);
+
+    string_printf(s, "%s%s%s", string_get(s), string_get(s), string_get(s));
+    TEST_CHECK(strcmp(string_get(s), "xabcxabcxabc") == 0);
+
+    string_destroy(s);
+}
+
+//alias is found also after arguments of other types
+static void test_self_printf_mixed(void){
+    string_t *s = NULL;
+
+    string_init_1(&s, "ab");
+    string_appendf(s, "|%*d|%.1f|%lld|%zu|%c|%s", 4, 7, 2.5, 9LL, (size_t)3, 'c', string_get(s));
+    TEST_CHECK(strcmp(string_get(s), "ab|   7|2.5|9|3|c|ab") == 0);
+
+    string_printf(s, "%-3s|%5.2s|%%|%p", "x", string_get(s), (void *)NULL);
+    TEST_CHECK(strncmp(string_get(s), "x  |   ab|%|", 12) == 0);
+
+    string_destroy(s);
+}
+
+//output longer than tail grows string
+static void test_printf_grows(void){
+    string_t *s = NULL;
+    char *line = ":10010000214601360121470136007EFE09D2190140";
+
+    string_init(&s);
+
+    for(int i = 0; i < 100; i++){
+        string_appendf(s, "%s%02X\n", line, i);
+    }
+
+    TEST_CHECK(string_length(s) == 100 * (strlen(line) + 3));
+    TEST_CHECK(strncmp(string_get(s) + 99 * (strlen(line) + 3), ":1001", 5) == 0);
+    TEST_CHECK(strcmp(string_get(s) + string_length(s) - 3, "63\n") == 0);
+
+    string_printf(s, "%d", 12345);
+    TEST_CHECK(strcmp(string_get(s), "12345") == 0 && string_length(s) == 5);
+
+    string_destroy(s);
+}
+
+int main(void){
+    test_self_append();
+    test_self_printf();
+    test_self_printf_mixed();
+    test_printf_grows();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,30 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include <utillib/core.h>
+
+#include "test.h"
+
+//view with zero character inside must not make compare read past end of string
+static void test_equal_cstr_embedded_zero(void){
+    char data[] = {'a', 'b', '\0', 'c', 'd'};
+    string_view_t view = string_view_make(data, sizeof(data));
+    char *s = (char *)malloc(3);
+
+    memcpy(s, "ab", 3);
+
+    TEST_CHECK(string_view_equal_cstr(view, s) == false);
+    TEST_CHECK(string_view_equal_cstr(string_view_make(data, 2), s) == true);
+    TEST_CHECK(string_view_equal_cstr(string_view_make(data, 3), s) == false);
+    TEST_CHECK(string_view_equal_cstr(string_view_make(data, 0), "") == true);
+    TEST_CHECK(string_view_equal_cstr(string_view_make(data, 1), "") == false);
+    TEST_CHECK(string_view_equal_cstr(string_view_make(data, 1), "ab") == false);
+
+    free(s);
+}
+
+int main(void){
+    test_equal_cstr_embedded_zero();
+
+    return TEST_RESULT();
+}
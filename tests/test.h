@@ -0,0 +1,25 @@
+/**
+ * @brief Minimal checks for regression tests.
+ *
+ * Every test is executable, that fails when any check fails.
+ */
+
+#ifndef TEST_H_included
+#define TEST_H_included
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static int test_failures = 0;
+
+#define TEST_CHECK(cond) \
+    do{ \
+        if(!(cond)){ \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    }while(0)
+
+#define TEST_RESULT() ((test_failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+#endif
@@ -0,0 +1,215 @@
+#include <string.h>
+
+#include <utillib/core.h>
+#include <utillib/utils.h>
+
+#include "test.h"
+
+//separator that depends on token read so far, buffer is used as C string
+static bool key_separator(tokenizer_t *this){
+    char *token = (char *)array_get_data(this->buffer);
+
+    if(this->state.current_char == ' ' || this->state.current_char == '\n')
+        return true;
+
+    return (this->state.current_char == ':' && strcmp(token, "key") == 0) ? true : false;
+}
+
+static void check_tokens(queue_t *output, char **expected, unsigned count){
+    TEST_CHECK(queue_count(output) == count);
+
+    for(unsigned i = 0; i < count && queue_count(output) > 0; i++){
+        token_t *token = NULL;
+        queue_windraw(output, (void *)&token);
+        TEST_CHECK(string_view_equal_cstr(token->text, expected[i]));
+        tokenizer_token_destroy(token);
+    }
+}
+
+//C-like comments are off until enabled, whatever memory tokenizer gets
+static void test_clike_comments_disabled(void){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    char *expected[] = {"a/*b*/c"};
+
+    void *garbage = dynmem_malloc(sizeof(tokenizer_t));
+    memset(garbage, 1, sizeof(tokenizer_t));
+    dynmem_free(garbage);
+
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, "a/*b*/c");
+    tokenizer_end(tokenizer, &output);
+
+    check_tokens(output, expected, 1);
+
+    queue_destroy(output);
+}
+
+//mark that ended comment is not in buffer, token before comment is kept
+static void test_comment_after_comment(void){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    char *expected[] = {"abc", "next", "x", "y"};
+
+    tokenizer_init(&tokenizer);
+    tokenizer_config_enable_c_like_comment(tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, "abc/* x *//rest\n next x//y\n y");
+    tokenizer_end(tokenizer, &output);
+
+    check_tokens(output, expected, 4);
+
+    queue_destroy(output);
+}
+
+static void test_buffer_is_terminated(void){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    char *expected[] = {"key", "value", "other:x", "keyboard", "key", "y"};
+
+    tokenizer_init(&tokenizer);
+    tokenizer_config_separator(tokenizer, key_separator);
+    tokenizer_tokenize_char_string(tokenizer, "key:value other:x keyboard key:y");
+    tokenizer_end(tokenizer, &output);
+
+    //"key" after "keyboard" is only found when terminator follows it
+    check_tokens(output, expected, 6);
+
+    queue_destroy(output);
+}
+
+//tokens are appended after tokens already in output queue
+static void test_end_appends_to_output(void){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    char *expected[] = {"first", "second", "third", "fourth"};
+
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, "first second");
+    tokenizer_end(tokenizer, &output);
+
+    tokenizer = NULL;
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, "third fourth");
+    tokenizer_end(tokenizer, &output);
+
+    check_tokens(output, expected, 4);
+
+    queue_destroy(output);
+}
+
+//tokens pulled one by one are same as tokens given by tokenizer_end()
+static bool next_equals_end(char *input, bool clike){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    token_t *token = NULL;
+    bool same = true;
+
+    tokenizer_init(&tokenizer);
+    if(clike)
+        tokenizer_config_enable_c_like_comment(tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, input);
+    tokenizer_end(tokenizer, &output);
+
+    tokenizer = NULL;
+    tokenizer_init(&tokenizer);
+    if(clike)
+        tokenizer_config_enable_c_like_comment(tokenizer);
+    tokenizer_begin_view(tokenizer, string_view_from(input));
+
+    while(tokenizer_next(tokenizer, &token)){
+        token_t *expected = NULL;
+
+        if(queue_count(output) == 0){
+            same = false;
+            tokenizer_token_destroy(token);
+            continue;
+        }
+
+        queue_windraw(output, (void *)&expected);
+
+        same = same && string_view_equal(token->text, expected->text);
+        same = same && (token->line_number == expected->line_number);
+        same = same && (token->column == expected->column);
+
+        tokenizer_token_destroy(expected);
+        tokenizer_token_destroy(token);
+    }
+
+    same = same && (queue_count(output) == 0);
+    same = same && !tokenizer_next(tokenizer, &token);
+    tokenizer_clean_output_queue(output);
+
+    output = NULL;
+    tokenizer_end(tokenizer, &output);
+    same = same && (queue_count(output) == 0);
+    queue_destroy(output);
+
+    return same;
+}
+
+static void test_next(void){
+    //last token is unfinished until end of input
+    TEST_CHECK(next_equals_end("mov a , b\nnop", false));
+    TEST_CHECK(next_equals_end("", false));
+    TEST_CHECK(next_equals_end("  \n \n", false));
+    TEST_CHECK(next_equals_end("f(a)(b) (c)\n((x))", false));
+    TEST_CHECK(next_equals_end("\"a (b)\" c", false));
+    TEST_CHECK(next_equals_end("a /* c\nd */ b // x\n c/*y*/d\n e", true));
+    TEST_CHECK(next_equals_end("abc/* unfinished", true));
+    TEST_CHECK(next_equals_end("abc// unfinished", true));
+}
+
+static void test_next_random(void){
+    const char alphabet[] = "ab (),/*\n \"";
+    char input[2001];
+    unsigned state = 7;
+    bool same = true;
+
+    for(unsigned round = 0; round < 200 && same; round++){
+        for(unsigned i = 0; i < sizeof(input) - 1; i++){
+            state = state * 1103515245u + 12345u;
+            input[i] = alphabet[(state >> 16) % (sizeof(alphabet) - 1)];
+        }
+        input[sizeof(input) - 1] = '\0';
+
+        same = next_equals_end(input, (round % 2) == 0);
+    }
+
+    TEST_CHECK(same);
+}
+
+//tokens left by tokenize functions are given first, buffer continues into view
+static void test_next_after_tokenize(void){
+    tokenizer_t *tokenizer = NULL;
+    queue_t *output = NULL;
+    token_t *token = NULL;
+    char *expected[] = {"x", "yz", "w"};
+    unsigned count = 0;
+
+    tokenizer_init(&tokenizer);
+    tokenizer_tokenize_char_string(tokenizer, "x y");
+    tokenizer_begin_view(tokenizer, string_view_from("z w"));
+
+    while(tokenizer_next(tokenizer, &token)){
+        TEST_CHECK(count < 3 && string_view_equal_cstr(token->text, expected[count]));
+        tokenizer_token_destroy(token);
+        count++;
+    }
+
+    TEST_CHECK(count == 3);
+
+    tokenizer_end(tokenizer, &output);
+    queue_destroy(output);
+}
+
+int main(void){
+    test_clike_comments_disabled();
+    test_comment_after_comment();
+    test_buffer_is_terminated();
+    test_end_appends_to_output();
+    test_next();
+    test_next_random();
+    test_next_after_tokenize();
+
+    return TEST_RESULT();
+}